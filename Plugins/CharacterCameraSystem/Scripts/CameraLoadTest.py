@@ -0,0 +1,145 @@
+"""
+Runs a local camera load test: a dedicated server and a number of bot clients on this machine, then reports the camera's frame cost and network traffic.
+
+The network traffic is the camera net profiler's estimate, built from the size of each camera RPC's parameters and replicated property. It doesn't include the bunch and
+packet overhead or anything else the net driver sends, so compare it against stat net or Networking Insights for the actual bandwidth.
+
+The server spawns target characters (-CameraBotTargets) and the clients add a UCameraBotComponent to their character (-CameraBots), which switches styles,
+swaps shoulders and cycles targets at random intervals. Each process captures a CSV profile, and the server logs the camera networking counters when it shuts down.
+
+Usage:
+    python CameraLoadTest.py <Editor or game executable> <.uproject> [--map /Game/Maps/Arena] [--clients 8] [--targets 16] [--frames 3600] [--out Saved/CameraLoadTest]
+"""
+
+import argparse
+import csv
+import glob
+import os
+import re
+import subprocess
+import sys
+import time
+
+
+CAMERA_COLUMNS = ("FrameTime", "GameThreadTime")
+CAMERA_PREFIX = "CharacterCamera/"
+NET_LINE = re.compile(r"Camera networking over ([\d.]+)s: (\d+) connections, (\d+) estimated bytes \(([\d.]+) bytes/s\)")
+
+
+def launch(executable, project, arguments, log_path):
+    command = [executable]
+    if project:
+        command.append(project)
+
+    command += arguments + ["-unattended", "-nopause", "-nosplash", "-abslog=" + log_path]
+    print(" ".join(command))
+    return subprocess.Popen(command)
+
+
+def percentile(values, fraction):
+    if not values:
+        return 0.0
+
+    values = sorted(values)
+    return values[min(int(len(values) * fraction), len(values) - 1)]
+
+
+def read_csv_profile(path):
+    """Returns each of the camera's columns in a CSV profile"""
+    columns = {}
+    with open(path, newline="") as file:
+        reader = csv.reader(file)
+        header = next(reader, [])
+        indices = {name: index for index, name in enumerate(header) if name in CAMERA_COLUMNS or name.startswith(CAMERA_PREFIX)}
+        for row in reader:
+            # The metadata rows at the end don't have numbers
+            if len(row) < len(header) or not row[0].replace(".", "", 1).isdigit():
+                continue
+
+            for name, index in indices.items():
+                try:
+                    columns.setdefault(name, []).append(float(row[index]))
+                except ValueError:
+                    pass
+
+    return columns
+
+
+def report(out_dir, num_clients):
+    lines = ["Camera load test: {} clients".format(num_clients), ""]
+
+    for path in sorted(glob.glob(os.path.join(out_dir, "**", "*.csv"), recursive=True)):
+        lines.append(os.path.relpath(path, out_dir))
+        for name, values in sorted(read_csv_profile(path).items()):
+            lines.append("  {:<40} avg {:>10.3f}  p95 {:>10.3f}  max {:>10.3f}".format(name, sum(values) / len(values), percentile(values, 0.95), max(values)))
+        lines.append("")
+
+    server_log = os.path.join(out_dir, "Server.log")
+    if os.path.exists(server_log):
+        lines.append("Server camera networking (estimated from the RPC parameters, without packet overhead)")
+        with open(server_log, errors="replace") as file:
+            dump = False
+            for line in file:
+                match = NET_LINE.search(line)
+                if match:
+                    dump = True
+                    duration, connections, total, rate = match.groups()
+                    lines.append("  {} connections over {}s: ~{} bytes, ~{} bytes/s (~{:.1f} bytes/s per client)".format(
+                        connections, duration, total, rate, float(rate) / max(num_clients, 1)))
+                elif dump and "CameraLog" in line and line.rstrip().split(": ", 2)[-1].startswith("  "):
+                    lines.append("  " + line.rstrip().split(": ", 2)[-1])
+                else:
+                    dump = False
+
+    text = "\n".join(lines)
+    with open(os.path.join(out_dir, "Report.txt"), "w") as file:
+        file.write(text)
+
+    print(text)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Runs a local multi process camera load test")
+    parser.add_argument("executable", help="The editor (with the project) or a packaged game executable")
+    parser.add_argument("project", nargs="?", default="", help="The .uproject, when running through the editor")
+    parser.add_argument("--map", default="", help="The map the server opens")
+    parser.add_argument("--clients", type=int, default=8, help="The number of bot clients")
+    parser.add_argument("--targets", type=int, default=16, help="The number of target characters the server spawns")
+    parser.add_argument("--frames", type=int, default=3600, help="The number of frames each process captures before exiting")
+    parser.add_argument("--port", type=int, default=7777)
+    parser.add_argument("--out", default=os.path.join("Saved", "CameraLoadTest"))
+    parser.add_argument("--timeout", type=float, default=600.0, help="Seconds to wait before the processes are killed")
+    args = parser.parse_args()
+
+    out_dir = os.path.abspath(os.path.join(args.out, time.strftime("%Y%m%d-%H%M%S")))
+    os.makedirs(out_dir, exist_ok=True)
+
+    # The server runs longer than the clients so their whole capture is on the server's log
+    server = launch(args.executable, args.project,
+        ([args.map] if args.map else []) + ["-server", "-nullrhi", "-port={}".format(args.port), "-CameraBotTargets={}".format(args.targets),
+         "-csvCaptureFrames={}".format(args.frames * 2), "-csvExitOnCompletion", "-csvOutputDir=" + os.path.join(out_dir, "Server")],
+        os.path.join(out_dir, "Server.log"))
+
+    # Give the server time to load the map before connecting
+    time.sleep(10.0)
+
+    clients = []
+    for index in range(args.clients):
+        clients.append(launch(args.executable, args.project,
+            ["127.0.0.1:{}".format(args.port), "-game", "-nullrhi", "-nosound", "-windowed", "-CameraBots", "-CameraBotSeed={}".format(index + 1),
+             "-csvCaptureFrames={}".format(args.frames), "-csvExitOnCompletion", "-csvOutputDir=" + os.path.join(out_dir, "Client{}".format(index))],
+            os.path.join(out_dir, "Client{}.log".format(index))))
+
+    deadline = time.time() + args.timeout
+    for process in clients + [server]:
+        try:
+            process.wait(max(deadline - time.time(), 1.0))
+        except subprocess.TimeoutExpired:
+            print("Process {} timed out".format(process.pid), file=sys.stderr)
+            process.kill()
+
+    report(out_dir, args.clients)
+
+
+if __name__ == "__main__":
+    main()
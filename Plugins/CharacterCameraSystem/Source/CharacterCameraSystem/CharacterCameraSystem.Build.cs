@@ -18,7 +18,8 @@ public class CharacterCameraSystem : ModuleRules
 				"Engine",
 				"NetCore",
 				"PhysicsCore",
-				"DataRegistry"
+				"DataRegistry",
+				"SignificanceManager"
 			}
 		);
 		
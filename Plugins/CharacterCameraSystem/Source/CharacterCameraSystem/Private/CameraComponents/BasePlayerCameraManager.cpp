@@ -3,23 +3,100 @@
 
 #include "CameraComponents/BasePlayerCameraManager.h"
 
+#include "CameraComponents/CameraRailActor.h"
 #include "Character/CharacterCameraLogic.h"
 #include "Camera/CameraComponent.h"
 #include "Camera/CameraActor.h"
 #include "Components/CapsuleComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/LocalPlayer.h"
+#include "EngineUtils.h"
 #include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/SpringArmComponent.h"
 #include "Kismet/KismetMathLibrary.h"
+#include "Subsystems/CameraRigSnapshotSubsystem.h"
+#include "WorldPartition/WorldPartitionSubsystem.h"
+
+DECLARE_CYCLE_STAT(TEXT("Camera Director"), STAT_CameraDirector, STATGROUP_CharacterCamera);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Camera Director Candidates"), STAT_CameraDirectorCandidates, STATGROUP_CharacterCamera);
+DECLARE_CYCLE_STAT(TEXT("Camera Group Framing"), STAT_CameraGroupFraming, STATGROUP_CharacterCamera);
 
 ABasePlayerCameraManager::ABasePlayerCameraManager(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
 	bAlwaysApplyModifiers = true; // TODO: Investigate this
+	bEnablePivotLag = false;
 	PivotLagSpeed = FVector(3.4);
+	PivotLagBounds = FVector(120.0, 120.0, 80.0);
+	RotationLagSpeed = 0.0;
 
 	// Camera values
 	CameraOrientation = ECameraOrientation::Center;
 	CameraStyle = CameraStyle_ThirdPerson;
 	CrouchBlendDuration = 0.5;
 	OutOfBoundsLagSpeed = 43.0;
+
+	// View publishing
+	TransformSync = ECameraTransformSync::SetActorTransform;
+	bSkipTransformSyncWithoutAttachments = false;
+
+	// Network priority
+	bUseCameraNetPriority = false;
+	InViewNetPriorityScale = 2.0;
+	BehindCameraNetPriorityScale = 0.5;
+	NetViewConeMargin = 10.0;
+	BehindCameraRelevancyDistance = 0.0;
+	bUseSpectatorViews = true;
+
+	// Streaming
+	bUseCameraStreamingSource = false;
+	StreamingPredictionTime = 1.5;
+	MaxStreamingPredictionDistance = 6400.0;
+	StreamingVelocityInterpSpeed = 6.0;
+	StreamingSourceRadius = 0.0;
+	StreamingSourcePriority = EStreamingSourcePriority::Normal;
+	bStreamingSourceRegistered = false;
+
+	// Rail camera
+	CameraRailDistance = 0.0;
+	bCameraRailDistanceValid = false;
+
+	// Group framing
+	GroupFramingMinArmLength = 400.0;
+	GroupFramingMaxArmLength = 2000.0;
+	GroupFramingMinPitch = -15.0;
+	GroupFramingMaxPitch = -50.0;
+	GroupFramingPitchRadius = 1500.0;
+	GroupFramingMaxFOV = 110.0;
+	GroupFramingPadding = 100.0;
+	GroupFramingInterpSpeed = 4.0;
+	GroupFramingRefinePerFrame = 8;
+	GroupFramingProbeSize = 12.0;
+	GroupFramingProbeChannel = ECC_Camera;
+	GroupFramingCenter = FVector::ZeroVector;
+	GroupFramingDistance = 0.0;
+	GroupFramingPitch = 0.0;
+	GroupFramingFOV = 0.0;
+	bGroupFramingValid = false;
+
+	// Rig snapshots
+	bWarmStartCameraRig = true;
+
+	// Spectator director
+	bUseSpectatorDirector = false;
+	DirectorCandidatesPerFrame = 8;
+	DirectorInterestHalfLife = 4.0;
+	DirectorSwitchMargin = 0.35;
+	DirectorMinShotDuration = 5.0;
+	DirectorBlendTime = 0.75;
+	DirectorCombatRadius = 2000.0;
+	DirectorCombatantInterest = 1.0;
+	DirectorTargetLockInterest = 4.0;
+	DirectorDamageInterest = 0.1;
+	DirectorCellSize = 2000.0;
+	DirectorCursor = 0;
+	DirectorPassBestScore = 0.0;
+	LastDirectorSwitchTime = 0.0;
+	bDirectorActive = false;
 }
 
 
@@ -36,6 +113,8 @@ void ABasePlayerCameraManager::UpdateViewTarget(FTViewTarget& OutVT, float Delta
 	Character = Character ? Character : Cast<ACharacterCameraLogic>(OutVT.Target);
 	if (Character)
 	{
+		// Apply the updates from after the character's tick before the camera reads them
+		Character->FlushCameraEvents();
 		CameraStyle = Character->Execute_GetCameraStyle(Character);
 		CameraOrientation = Character->Execute_GetCameraOrientation(Character);
 	}
@@ -58,6 +137,15 @@ void ABasePlayerCameraManager::UpdateViewTarget(FTViewTarget& OutVT, float Delta
 		// Viewing through a fixed camera actor.
 		CamActor->GetCameraComponent()->GetCameraView(DeltaTime, OutVT.POV);
 	}
+	else if (const ACharacterCameraLogic* ViewTargetCharacter = bUseSpectatorViews ? Cast<ACharacterCameraLogic>(OutVT.Target) : nullptr;
+		ViewTargetCharacter && ViewTargetCharacter->GetSpectatorView(OutVT.POV.Location, OutVT.POV.Rotation, OutVT.POV.FOV))
+	{
+		// The cached character is the pending view target while blending, so the view target being updated is used instead
+		// Spectating another player with their replicated view, which already has their camera modifiers
+		SyncActorTransformToView(OutVT.POV);
+		UpdateCameraLensEffects(OutVT);
+		return;
+	}
 	else
 	{
 		// If there's blueprint logic that takes precedence, use that instead
@@ -94,6 +182,16 @@ void ABasePlayerCameraManager::UpdateViewTarget(FTViewTarget& OutVT, float Delta
 			SpectatorCameraBehavior(DeltaTime, OutVT);
 			bApplyModifiers = true;
 		}
+		else if (CameraStyle == CameraStyle_Rail)
+		{
+			RailCameraBehavior(DeltaTime, OutVT);
+			bApplyModifiers = true;
+		}
+		else if (CameraStyle == CameraStyle_GroupFraming)
+		{
+			GroupFramingCameraBehavior(DeltaTime, OutVT);
+			bApplyModifiers = true;
+		}
 		else if (CameraStyle == CameraStyle_Fixed)
 		{
 			// do not update, keep previous camera position by restoring
@@ -107,14 +205,24 @@ void ABasePlayerCameraManager::UpdateViewTarget(FTViewTarget& OutVT, float Delta
 
 	}
 
+	if (CameraStyle != CameraStyle_Rail)
+	{
+		bCameraRailDistanceValid = false;
+	}
+
+	if (CameraStyle != CameraStyle_GroupFraming)
+	{
+		bGroupFramingValid = false;
+	}
+
 	if (bApplyModifiers || bAlwaysApplyModifiers)
 	{
 		// Apply camera modifiers at the end (view shakes for example)
 		ApplyCameraModifiers(DeltaTime, OutVT.POV);
 	}
 
-	// Synchronize the actor with the view target results // TODO: Why is the camera affecting the actor location, and is this causing net corrections?
-	SetActorLocationAndRotation(OutVT.POV.Location, OutVT.POV.Rotation, false);
+	// Synchronize the actor with the view target results. The camera manager isn't replicated, so this doesn't cause net corrections, it's just component and overlap work
+	SyncActorTransformToView(OutVT.POV);
 
 	UpdateCameraLensEffects(OutVT);
 }
@@ -149,6 +257,7 @@ void ABasePlayerCameraManager::FirstPersonCameraBehavior_Implementation(float De
 void ABasePlayerCameraManager::ThirdPersonCameraBehavior_Implementation(float DeltaTime, FTViewTarget& OutVT)
 {
 	UpdateViewTargetInternal(OutVT, DeltaTime);
+	ApplyPivotLag(OutVT, DeltaTime);
 	// Target Lock logic for third person is tied to the spring arm component
 }
 
@@ -164,6 +273,7 @@ void ABasePlayerCameraManager::ThirdPersonAimingCameraBehavior_Implementation(fl
 void ABasePlayerCameraManager::TargetLockCameraBehavior_Implementation(float DeltaTime, FTViewTarget& OutVT)
 {
 	UpdateViewTargetInternal(OutVT, DeltaTime);
+	ApplyPivotLag(OutVT, DeltaTime);
 	// Target lock behavior is handled during the Camera Arm's update logic to handle smoothing and transitions properly
 }
 
@@ -174,6 +284,152 @@ void ABasePlayerCameraManager::SpectatorCameraBehavior_Implementation(float Delt
 }
 
 
+void ABasePlayerCameraManager::RailCameraBehavior_Implementation(float DeltaTime, FTViewTarget& OutVT)
+{
+	if (!CameraRail || !OutVT.Target)
+	{
+		UpdateViewTargetInternal(OutVT, DeltaTime);
+		return;
+	}
+
+	CameraRail->EvaluateView(OutVT.Target->GetActorLocation(), DeltaTime, !bCameraRailDistanceValid, CameraRailDistance, OutVT.POV.Location, OutVT.POV.Rotation);
+	bCameraRailDistanceValid = true;
+	if (CameraRail->FieldOfView > 0.0f)
+	{
+		OutVT.POV.FOV = CameraRail->FieldOfView;
+	}
+}
+
+
+void ABasePlayerCameraManager::SetCameraRail(ACameraRailActor* Rail)
+{
+	CameraRail = Rail;
+	bCameraRailDistanceValid = false;
+}
+
+
+ACameraRailActor* ABasePlayerCameraManager::GetCameraRail() const
+{
+	return CameraRail;
+}
+
+
+void ABasePlayerCameraManager::GroupFramingCameraBehavior_Implementation(float DeltaTime, FTViewTarget& OutVT)
+{
+	SCOPE_CYCLE_COUNTER(STAT_CameraGroupFraming);
+	UpdateGroupBounds(OutVT.Target);
+	if (!GroupBounds.IsValid())
+	{
+		UpdateViewTargetInternal(OutVT, DeltaTime);
+		return;
+	}
+
+	// The distance that fits the group within the narrower of the horizontal and vertical field of view
+	const float Radius = GroupBounds.Radius + GroupFramingPadding;
+	const float AspectRatio = OutVT.POV.AspectRatio > 0.0f ? OutVT.POV.AspectRatio : 1.0f;
+	const float HalfFOV = FMath::DegreesToRadians(DefaultFOV * 0.5f);
+	const float HalfVerticalFOV = FMath::Atan(FMath::Tan(HalfFOV) / AspectRatio);
+	float Distance = Radius / FMath::Sin(FMath::Min(HalfFOV, HalfVerticalFOV));
+	float FOV = DefaultFOV;
+
+	// Past the longest arm length the field of view widens to fit the group instead
+	if (Distance > GroupFramingMaxArmLength)
+	{
+		Distance = FMath::Max(GroupFramingMaxArmLength, Radius + 1.0f);
+		const float RequiredHalfFOV = FMath::Asin(FMath::Min(Radius / Distance, 1.0f));
+		const float RequiredHorizontalHalfFOV = HalfVerticalFOV < HalfFOV ? FMath::Atan(FMath::Tan(RequiredHalfFOV) * AspectRatio) : RequiredHalfFOV;
+		FOV = FMath::Clamp(FMath::RadiansToDegrees(RequiredHorizontalHalfFOV * 2.0f), DefaultFOV, GroupFramingMaxFOV);
+	}
+
+	Distance = FMath::Max(Distance, GroupFramingMinArmLength);
+	const float Pitch = FMath::Lerp(GroupFramingMinPitch, GroupFramingMaxPitch, FMath::Clamp(GroupBounds.Radius / GroupFramingPitchRadius, 0.0f, 1.0f));
+
+	if (!bGroupFramingValid || GroupFramingInterpSpeed <= 0.0f)
+	{
+		GroupFramingCenter = GroupBounds.Center;
+		GroupFramingDistance = Distance;
+		GroupFramingPitch = Pitch;
+		GroupFramingFOV = FOV;
+		bGroupFramingValid = true;
+	}
+	else
+	{
+		GroupFramingCenter = FMath::VInterpTo(GroupFramingCenter, GroupBounds.Center, DeltaTime, GroupFramingInterpSpeed);
+		GroupFramingDistance = FMath::FInterpTo(GroupFramingDistance, Distance, DeltaTime, GroupFramingInterpSpeed);
+		GroupFramingPitch = FMath::FInterpTo(GroupFramingPitch, Pitch, DeltaTime, GroupFramingInterpSpeed);
+		GroupFramingFOV = FMath::FInterpTo(GroupFramingFOV, FOV, DeltaTime, GroupFramingInterpSpeed);
+	}
+
+	// The player still controls the yaw, the group decides everything else
+	const APawn* Pawn = Cast<APawn>(OutVT.Target);
+	const FRotator ControlRotation = Pawn ? Pawn->GetControlRotation() : OutVT.Target->GetActorRotation();
+	OutVT.POV.Rotation = FRotator(GroupFramingPitch, ControlRotation.Yaw, 0.0);
+	OutVT.POV.Location = GroupFramingCenter - OutVT.POV.Rotation.Vector() * GroupFramingDistance;
+	OutVT.POV.FOV = GroupFramingFOV;
+
+	// Pull the camera in front of anything between it and the group, with the same probe as the view target's camera arm
+	const USpringArmComponent* CameraArm = OutVT.Target->FindComponentByClass<USpringArmComponent>();
+	const float ProbeSize = CameraArm ? CameraArm->ProbeSize : GroupFramingProbeSize;
+	const ECollisionChannel ProbeChannel = CameraArm ? CameraArm->ProbeChannel.GetValue() : GroupFramingProbeChannel.GetValue();
+
+	FHitResult Hit;
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(GroupFramingCamera), false, OutVT.Target);
+	if (GetWorld()->SweepSingleByChannel(Hit, GroupFramingCenter, OutVT.POV.Location, FQuat::Identity, ProbeChannel, FCollisionShape::MakeSphere(ProbeSize), QueryParams))
+	{
+		OutVT.POV.Location = Hit.Location;
+	}
+}
+
+
+void ABasePlayerCameraManager::UpdateGroupBounds(AActor* ViewTarget)
+{
+	// The group is the view target and it's valid target lock characters
+	TArray<AActor*, TInlineAllocator<16>> Members;
+	if (ViewTarget) Members.Add(ViewTarget);
+	if (ACharacterCameraLogic* TargetCharacter = Cast<ACharacterCameraLogic>(ViewTarget))
+	{
+		for (AActor* Target : TargetCharacter->GetTargetLockCharactersReference())
+		{
+			if (IsValid(Target) && Target != ViewTarget) Members.Add(Target);
+		}
+	}
+
+	bool bMembersChanged = Members.Num() != GroupMembers.Num();
+	for (int32 Index = 0; !bMembersChanged && Index < Members.Num(); ++Index)
+	{
+		bMembersChanged = GroupMembers[Index] != Members[Index];
+	}
+
+	if (bMembersChanged)
+	{
+		GroupMembers.Reset();
+		GroupBounds.Reset();
+		for (AActor* Member : Members)
+		{
+			GroupMembers.Add(Member);
+			GroupBounds.AddMember(Member->GetActorLocation());
+		}
+
+		return;
+	}
+
+	for (int32 Index = 0; Index < Members.Num(); ++Index)
+	{
+		GroupBounds.UpdateMember(Index, Members[Index]->GetActorLocation());
+	}
+
+	GroupBounds.Refine(GroupFramingRefinePerFrame);
+}
+
+
+bool ABasePlayerCameraManager::GetGroupFramingBounds(FVector& Center, float& Radius) const
+{
+	Center = GroupBounds.Center;
+	Radius = GroupBounds.Radius;
+	return GroupBounds.IsValid();
+}
+
+
 void ABasePlayerCameraManager::BP_UpdateViewTarget_Implementation(FTViewTarget& OutVT, float DeltaTime, bool& bApplyModifiers)
 {
 	UpdateViewTargetInternal(OutVT, DeltaTime);
@@ -186,17 +442,67 @@ FVector ABasePlayerCameraManager::CalculateCameraDrag(FVector Current, FVector T
 	CameraRotation.Pitch = 0.0f;
 	CameraRotation.Roll = 0.0f;
 
+	// The lag is calculated relative to the target in the camera's yaw space, so each axis is (forward, right, up)
 	const FQuat CameraRotationQuaternion = CameraRotation.Quaternion();
-	const FVector UnRotatedCurrentLocation = UKismetMathLibrary::Quat_UnrotateVector(CameraRotationQuaternion, Current);
-	const FVector UnRotatedTargetLocation = UKismetMathLibrary::Quat_UnrotateVector(CameraRotationQuaternion, Target);
-	const FVector CameraDragLocation = FVector(
-		UKismetMathLibrary::FInterpTo(UnRotatedCurrentLocation.X, UnRotatedTargetLocation.X, DeltaTime, PivotLagSpeed.X),
-		UKismetMathLibrary::FInterpTo(UnRotatedCurrentLocation.Y, UnRotatedTargetLocation.Y, DeltaTime, PivotLagSpeed.Y),
-		UKismetMathLibrary::FInterpTo(UnRotatedCurrentLocation.Z, UnRotatedTargetLocation.Z, DeltaTime, PivotLagSpeed.Z)
-	);
+	const FVector LocalLag = CameraRotationQuaternion.UnrotateVector(Current - Target);
+
+	// FInterpTo on every axis at once, with the out of bounds axes using the out of bounds lag speed
+	const VectorRegister4Double Zero = VectorZeroDouble();
+	const VectorRegister4Double One = VectorOneDouble();
+	const VectorRegister4Double Lag = VectorLoadFloat3_W0(&LocalLag);
+	const VectorRegister4Double Bounds = VectorLoadFloat3_W0(&PivotLagBounds);
+	const VectorRegister4Double Bounded = VectorCompareGT(Bounds, Zero);
+	const VectorRegister4Double OutOfBounds = VectorBitwiseAnd(Bounded, VectorCompareGT(VectorAbs(Lag), Bounds));
+	const VectorRegister4Double Speed = VectorSelect(OutOfBounds, MakeVectorRegisterDouble(OutOfBoundsLagSpeed, OutOfBoundsLagSpeed, OutOfBoundsLagSpeed, 0.0), VectorLoadFloat3_W0(&PivotLagSpeed));
+
+	// A speed of zero or less snaps to the target like FInterpTo
+	VectorRegister4Double Alpha = VectorMin(VectorMax(VectorMultiply(Speed, MakeVectorRegisterDouble(DeltaTime, DeltaTime, DeltaTime, 0.0)), Zero), One);
+	Alpha = VectorSelect(VectorCompareGT(Speed, Zero), Alpha, One);
+	VectorRegister4Double Result = VectorMultiply(Lag, VectorSubtract(One, Alpha));
+
+	// Clamp the bounded axes to their bounds
+	const VectorRegister4Double Clamped = VectorMin(VectorMax(Result, VectorNegate(Bounds)), Bounds);
+	Result = VectorSelect(Bounded, Clamped, Result);
+
+	FVector CameraDragLag;
+	VectorStoreFloat3(Result, &CameraDragLag);
+	return Target + CameraRotationQuaternion.RotateVector(CameraDragLag);
+}
+
+
+void ABasePlayerCameraManager::ApplyPivotLag(FTViewTarget& OutVT, const float DeltaTime)
+{
+	// The pending view target of a blend doesn't have it's own lag state
+	if (!bEnablePivotLag || !OutVT.Target || !OutVT.Equal(ViewTarget)) return;
+
+	CharacterLocation = OutVT.Target->GetActorLocation();
+	CharacterRotation = OutVT.Target->GetActorRotation();
+	TargetLocation = CharacterLocation;
+	TargetRotation = OutVT.POV.Rotation;
+
+	// Start without any lag for new view targets
+	if (PivotLagTarget != OutVT.Target)
+	{
+		PivotLagTarget = OutVT.Target;
+		SmoothTargetLocation = TargetLocation;
+		SmoothTargetRotation = TargetRotation;
+	}
+
+	SmoothTargetLocation = CalculateCameraDrag(SmoothTargetLocation, TargetLocation, OutVT.POV.Rotation, DeltaTime);
+	CalculatedLocation = OutVT.POV.Location + (SmoothTargetLocation - TargetLocation);
+	OutVT.POV.Location = CalculatedLocation;
 
-	UKismetMathLibrary::Quat_RotateVector(CameraRotationQuaternion, CameraDragLocation);
-	return CameraDragLocation;
+	if (RotationLagSpeed > 0.0f)
+	{
+		SmoothTargetRotation = FMath::QInterpTo(SmoothTargetRotation.Quaternion(), TargetRotation.Quaternion(), DeltaTime, RotationLagSpeed).Rotator();
+		CalculatedRotation = SmoothTargetRotation;
+		OutVT.POV.Rotation = CalculatedRotation;
+	}
+	else
+	{
+		SmoothTargetRotation = TargetRotation;
+		CalculatedRotation = TargetRotation;
+	}
 }
 
 
@@ -223,10 +529,597 @@ void ABasePlayerCameraManager::InAirCrouchLogic(FTViewTarget& OutVT, float Delta
 }
 
 
+void ABasePlayerCameraManager::SyncActorTransformToView(const FMinimalViewInfo& POV)
+{
+	if (TransformSync == ECameraTransformSync::ViewTargetOnly) return;
+	if (bSkipTransformSyncWithoutAttachments && !HasAttachedViewDependents()) return;
+
+	USceneComponent* Root = GetRootComponent();
+	if (!Root) return;
+	if (Root->GetComponentLocation() == POV.Location && Root->GetComponentRotation() == POV.Rotation) return;
+
+	if (TransformSync == ECameraTransformSync::Teleport)
+	{
+		// Skips the sweep, overlap and physics updates, and only propagates the transform to the attached components
+		Root->SetWorldLocationAndRotationNoPhysics(POV.Location, POV.Rotation);
+	}
+	else
+	{
+		SetActorLocationAndRotation(POV.Location, POV.Rotation, false);
+	}
+}
+
+
+bool ABasePlayerCameraManager::HasAttachedViewDependents() const
+{
+	// Attached actors are attached to the root component, so they're also included in the attach children
+	const USceneComponent* Root = GetRootComponent();
+	return Root && Root->GetAttachChildren().Num() > 0;
+}
+
+
+#pragma region Network Priority
+FCameraNetView ABasePlayerCameraManager::GetCameraNetView() const
+{
+	const FMinimalViewInfo& CameraView = GetCameraCacheView();
+	const float FOV = ReportedViewFOV > 0.0f ? ReportedViewFOV : CameraView.FOV;
+
+	FCameraNetView NetView;
+	NetView.Location = CameraView.Location;
+	NetView.Direction = CameraView.Rotation.Vector();
+	NetView.CosHalfFOV = FMath::Cos(FMath::DegreesToRadians(FMath::Clamp(FOV * 0.5f + NetViewConeMargin, 0.0f, 180.0f)));
+	NetView.bValid = GetCameraCacheTime() > 0.0f;
+	return NetView;
+}
+
+
+float ABasePlayerCameraManager::GetNetPriorityScale(const AActor* Actor) const
+{
+	if (!Actor) return 1.0f;
+	const FCameraNetView NetView = GetCameraNetView();
+	if (!NetView.bValid) return 1.0f;
+
+	const FVector ToActor = Actor->GetActorLocation() - NetView.Location;
+	const float Distance = ToActor.Size();
+	if (Distance < UE_KINDA_SMALL_NUMBER) return InViewNetPriorityScale;
+
+	const float CosAngle = FVector::DotProduct(ToActor / Distance, NetView.Direction);
+	if (CosAngle >= NetView.CosHalfFOV) return InViewNetPriorityScale;
+	if (CosAngle < 0.0f) return BehindCameraNetPriorityScale;
+	return 1.0f;
+}
+
+
+bool ABasePlayerCameraManager::IsNetRelevantToCamera(const AActor* Actor) const
+{
+	if (!Actor || BehindCameraRelevancyDistance <= 0.0f) return true;
+	const FCameraNetView NetView = GetCameraNetView();
+	if (!NetView.bValid) return true;
+
+	const FVector ToActor = Actor->GetActorLocation() - NetView.Location;
+	if (FVector::DotProduct(ToActor, NetView.Direction) >= 0.0f) return true;
+	return ToActor.SizeSquared() <= FMath::Square(BehindCameraRelevancyDistance);
+}
+
+
+void ABasePlayerCameraManager::SetReportedViewFOV(const float FOV)
+{
+	ReportedViewFOV = FOV;
+}
+
+
+float ABasePlayerCameraManager::ScaleNetPriorityForViewer(const AActor* Actor, const AActor* Viewer, const float Priority)
+{
+	const ABasePlayerCameraManager* CameraManager = GetNetPriorityCameraManager(Viewer);
+	return CameraManager ? Priority * CameraManager->GetNetPriorityScale(Actor) : Priority;
+}
+
+
+const ABasePlayerCameraManager* ABasePlayerCameraManager::GetNetPriorityCameraManager(const AActor* Viewer)
+{
+	const APlayerController* PlayerController = Cast<APlayerController>(Viewer);
+	if (!PlayerController) return nullptr;
+
+	const ABasePlayerCameraManager* CameraManager = Cast<ABasePlayerCameraManager>(PlayerController->PlayerCameraManager);
+	return CameraManager && CameraManager->bUseCameraNetPriority ? CameraManager : nullptr;
+}
+#pragma endregion
+
+
+
+
+#pragma region Streaming
+void ABasePlayerCameraManager::InitializeFor(APlayerController* PC)
+{
+	Super::InitializeFor(PC);
+
+	// Actor names repeat across play in editor instances and split screen players, so the sources are named after both
+	const FWorldContext* WorldContext = GEngine ? GEngine->GetWorldContextFromWorld(GetWorld()) : nullptr;
+	const ULocalPlayer* LocalPlayer = PC ? PC->GetLocalPlayer() : nullptr;
+	const FString SourcePrefix = FString::Printf(TEXT("%s_%d_%d"), *GetName(), WorldContext ? WorldContext->PIEInstance : INDEX_NONE, LocalPlayer ? LocalPlayer->GetControllerId() : INDEX_NONE);
+	PredictedStreamingSourceName = FName(*FString::Printf(TEXT("%s_Predicted"), *SourcePrefix));
+	PendingViewTargetStreamingSourceName = FName(*FString::Printf(TEXT("%s_PendingViewTarget"), *SourcePrefix));
+	PrewarmStreamingSourceName = FName(*FString::Printf(TEXT("%s_Prewarm"), *SourcePrefix));
+	UpdateStreamingSourceRegistration();
+	SetSpectatorDirectorEnabled(bUseSpectatorDirector);
+
+	// Continue from the snapshot of the previous level's camera
+	int32 ControllerId;
+	if (const UCameraRigSnapshotSubsystem* SnapshotSubsystem = GetRigSnapshotSubsystem(ControllerId))
+	{
+		SnapshotSubsystem->FindSnapshot(ControllerId, RigSnapshot);
+	}
+}
+
+
+void ABasePlayerCameraManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (bStreamingSourceRegistered)
+	{
+		if (UWorldPartitionSubsystem* WorldPartitionSubsystem = GetWorld()->GetSubsystem<UWorldPartitionSubsystem>())
+		{
+			WorldPartitionSubsystem->UnregisterStreamingSourceProvider(this);
+		}
+		bStreamingSourceRegistered = false;
+	}
+
+	SetSpectatorDirectorEnabled(false);
+
+	int32 ControllerId;
+	if (UCameraRigSnapshotSubsystem* SnapshotSubsystem = bWarmStartCameraRig ? GetRigSnapshotSubsystem(ControllerId) : nullptr)
+	{
+		SnapshotSubsystem->StoreSnapshot(ControllerId, RigSnapshot);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+
+void ABasePlayerCameraManager::UpdateCamera(const float DeltaTime)
+{
+	Super::UpdateCamera(DeltaTime);
+
+	if (bStreamingSourceRegistered)
+	{
+		UpdateStreamingPrediction(DeltaTime);
+	}
+
+	if (bDirectorActive)
+	{
+		UpdateSpectatorDirector();
+	}
+
+	// The pawn is usually already destroyed by the time the view target changes, so the snapshot is kept up to date instead of captured then
+	if (bWarmStartCameraRig && IsRigSnapshotCharacter(Character))
+	{
+		RigSnapshot = Character->CaptureCameraRigSnapshot();
+		RigSnapshotCharacter = Character;
+	}
+}
+
+
+void ABasePlayerCameraManager::UpdateStreamingSourceRegistration()
+{
+	UWorldPartitionSubsystem* WorldPartitionSubsystem = GetWorld() ? GetWorld()->GetSubsystem<UWorldPartitionSubsystem>() : nullptr;
+	if (!WorldPartitionSubsystem) return;
+
+	const bool bRegister = bUseCameraStreamingSource && PCOwner && PCOwner->IsLocalController();
+	if (bRegister == bStreamingSourceRegistered) return;
+
+	if (bRegister)
+	{
+		WorldPartitionSubsystem->RegisterStreamingSourceProvider(this);
+		PreviousCameraLocation = GetCameraCacheView().Location;
+		CameraVelocity = FVector::ZeroVector;
+	}
+	else
+	{
+		WorldPartitionSubsystem->UnregisterStreamingSourceProvider(this);
+	}
+
+	bStreamingSourceRegistered = bRegister;
+}
+
+
+void ABasePlayerCameraManager::UpdateStreamingPrediction(const float DeltaTime)
+{
+	const FVector CameraLocation = GetCameraCacheView().Location;
+
+	// View target changes teleport the camera, which isn't part of it's trajectory
+	if (PreviousStreamingViewTarget.Get() != GetViewTarget() || DeltaTime <= UE_SMALL_NUMBER)
+	{
+		PreviousStreamingViewTarget = GetViewTarget();
+		CameraVelocity = FVector::ZeroVector;
+	}
+	else
+	{
+		const FVector Velocity = (CameraLocation - PreviousCameraLocation) / DeltaTime;
+		CameraVelocity = FMath::VInterpTo(CameraVelocity, Velocity, DeltaTime, StreamingVelocityInterpSpeed);
+	}
+	PreviousCameraLocation = CameraLocation;
+
+	const double WorldTime = GetWorld()->GetTimeSeconds();
+	StreamingPrewarmLocations.RemoveAllSwap([WorldTime](const TPair<FVector, double>& Prewarm) { return Prewarm.Value <= WorldTime; });
+}
+
+
+bool ABasePlayerCameraManager::GetStreamingSources(TArray<FWorldPartitionStreamingSource>& StreamingSources) const
+{
+	if (!bStreamingSourceRegistered) return false;
+	const int32 NumSources = StreamingSources.Num();
+	const FRotator CameraRotation = GetCameraCacheView().Rotation;
+
+	// The pawn's streaming source already covers the current location, so only the predicted location is added
+	if (!CameraVelocity.IsNearlyZero(1.0))
+	{
+		FWorldPartitionStreamingSource& Source = StreamingSources.Add_GetRef(MakeStreamingSource(PredictedStreamingSourceName, GetPredictedCameraLocation(), CameraRotation));
+		Source.Velocity = CameraVelocity.Size();
+	}
+
+	// Stream in the destination of view target blends before the blend arrives
+	if (PendingViewTarget.Target && BlendTimeToGo > 0.0f)
+	{
+		const FVector Destination = PendingViewTarget.POV.Location.IsZero() ? PendingViewTarget.Target->GetActorLocation() : PendingViewTarget.POV.Location;
+		StreamingSources.Add(MakeStreamingSource(PendingViewTargetStreamingSourceName, Destination, PendingViewTarget.POV.Rotation));
+	}
+
+	const double WorldTime = GetWorld()->GetTimeSeconds();
+	for (const TPair<FVector, double>& Prewarm : StreamingPrewarmLocations)
+	{
+		if (Prewarm.Value <= WorldTime) continue;
+		StreamingSources.Add(MakeStreamingSource(PrewarmStreamingSourceName, Prewarm.Key, CameraRotation));
+	}
+
+	return StreamingSources.Num() > NumSources;
+}
+
+
+FWorldPartitionStreamingSource ABasePlayerCameraManager::MakeStreamingSource(const FName Name, const FVector& Location, const FRotator& Rotation) const
+{
+	FWorldPartitionStreamingSource Source;
+	Source.Name = Name;
+	Source.Location = Location;
+	Source.Rotation = Rotation;
+	Source.TargetState = EStreamingSourceTargetState::Activated;
+	Source.Priority = StreamingSourcePriority;
+
+	if (StreamingSourceRadius > 0.0f)
+	{
+		FStreamingSourceShape& Shape = Source.Shapes.AddDefaulted_GetRef();
+		Shape.bUseGridLoadingRange = false;
+		Shape.Radius = StreamingSourceRadius;
+	}
+
+	return Source;
+}
+
+
+FVector ABasePlayerCameraManager::GetPredictedCameraLocation() const
+{
+	const FVector Prediction = (CameraVelocity * StreamingPredictionTime).GetClampedToMaxSize(MaxStreamingPredictionDistance);
+	return GetCameraCacheView().Location + Prediction;
+}
+
+
+void ABasePlayerCameraManager::AddStreamingPrewarmLocation(const FVector Location, const float Duration)
+{
+	if (!GetWorld() || Duration <= 0.0f) return;
+	StreamingPrewarmLocations.Emplace(Location, GetWorld()->GetTimeSeconds() + Duration);
+}
+#pragma endregion
+
+
+
+
+
+#pragma region Spectator Director
+void ABasePlayerCameraManager::SetSpectatorDirectorEnabled(const bool bEnabled)
+{
+	bUseSpectatorDirector = bEnabled;
+	UWorld* World = GetWorld();
+	const bool bActivate = bEnabled && World && PCOwner && PCOwner->IsLocalController();
+	if (bActivate == bDirectorActive) return;
+	bDirectorActive = bActivate;
+
+	if (bActivate)
+	{
+		DirectorCellSize = FMath::Max(DirectorCombatRadius, 100.0f);
+		for (TActorIterator<ACharacterCameraLogic> It(World); It; ++It)
+		{
+			AddDirectorCandidate(*It);
+		}
+
+		DirectorSpawnHandle = World->AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &ABasePlayerCameraManager::OnDirectorActorSpawned));
+		LastDirectorSwitchTime = -DirectorMinShotDuration;
+	}
+	else
+	{
+		if (World) World->RemoveOnActorSpawnedHandler(DirectorSpawnHandle);
+		DirectorSpawnHandle.Reset();
+
+		while (!DirectorCandidates.IsEmpty())
+		{
+			RemoveDirectorCandidateAt(DirectorCandidates.Num() - 1);
+		}
+		DirectorCellCounts.Reset();
+		DirectorCursor = 0;
+		DirectorPassBest.Reset();
+	}
+}
+
+
+void ABasePlayerCameraManager::ReportDirectorEvent(AActor* Actor, const float Interest)
+{
+	const int32* Index = Actor ? DirectorCandidateIndices.Find(Actor) : nullptr;
+	if (!Index) return;
+	DirectorCandidates[*Index].AddEventInterest(Interest, GetWorld()->GetTimeSeconds(), GetDirectorDecayRate());
+}
+
+
+float ABasePlayerCameraManager::GetDirectorScore(const AActor* Actor) const
+{
+	const int32* Index = Actor ? DirectorCandidateIndices.Find(Actor) : nullptr;
+	if (!Index) return 0.0f;
+	return DirectorCandidates[*Index].GetScore(GetWorld()->GetTimeSeconds(), GetDirectorDecayRate());
+}
+
+
+void ABasePlayerCameraManager::AddDirectorCandidate(AActor* Actor)
+{
+	if (!IsDirectorCandidate(Actor) || DirectorCandidateIndices.Contains(Actor)) return;
+
+	FCameraDirectorCandidate& Candidate = DirectorCandidates.AddDefaulted_GetRef();
+	Candidate.Actor = Actor;
+	Candidate.Location = Actor->GetActorLocation();
+	Candidate.Cell = GetDirectorCell(Candidate.Location);
+	Candidate.EventTime = GetWorld()->GetTimeSeconds();
+	DirectorCellCounts.FindOrAdd(Candidate.Cell)++;
+	DirectorCandidateIndices.Add(Actor, DirectorCandidates.Num() - 1);
+
+	// Everything that happened before the director saw the candidate isn't an event
+	if (const ACharacterCameraLogic* CandidateCharacter = Cast<ACharacterCameraLogic>(Actor))
+	{
+		Candidate.LastState = CandidateCharacter->GetDirectorState();
+	}
+}
+
+
+void ABasePlayerCameraManager::RemoveDirectorCandidate(AActor* Actor)
+{
+	if (const int32* Index = Actor ? DirectorCandidateIndices.Find(Actor) : nullptr)
+	{
+		RemoveDirectorCandidateAt(*Index);
+	}
+}
+
+
+void ABasePlayerCameraManager::RemoveDirectorCandidateAt(const int32 Index)
+{
+	const FCameraDirectorCandidate& Candidate = DirectorCandidates[Index];
+	int32& CellCount = DirectorCellCounts.FindOrAdd(Candidate.Cell);
+	if (--CellCount <= 0) DirectorCellCounts.Remove(Candidate.Cell);
+
+	// Weak pointers keep their hash once the actor is destroyed, so destroyed candidates are still found
+	DirectorCandidateIndices.Remove(Candidate.Actor);
+	DirectorCandidates.RemoveAtSwap(Index, 1, false);
+	if (DirectorCandidates.IsValidIndex(Index))
+	{
+		DirectorCandidateIndices.Add(DirectorCandidates[Index].Actor, Index);
+	}
+}
+
+
+void ABasePlayerCameraManager::UpdateSpectatorDirector()
+{
+	SCOPE_CYCLE_COUNTER(STAT_CameraDirector);
+	SET_DWORD_STAT(STAT_CameraDirectorCandidates, DirectorCandidates.Num());
+	if (DirectorCandidates.IsEmpty()) return;
+
+	const double Time = GetWorld()->GetTimeSeconds();
+	const float DecayRate = GetDirectorDecayRate();
+	int32 Budget = FMath::Min(DirectorCandidatesPerFrame, DirectorCandidates.Num());
+	while (Budget > 0 && !DirectorCandidates.IsEmpty())
+	{
+		// The end of a pass, every candidate's score is up to date
+		if (DirectorCursor >= DirectorCandidates.Num())
+		{
+			TrySwitchDirectorViewTarget(Time, DecayRate);
+			DirectorCursor = 0;
+			DirectorPassBest.Reset();
+			DirectorPassBestScore = 0.0f;
+		}
+
+		// The last candidate is swapped into the removed candidate's place, so the cursor stays where it is
+		FCameraDirectorCandidate& Candidate = DirectorCandidates[DirectorCursor];
+		if (!Candidate.Actor.IsValid())
+		{
+			RemoveDirectorCandidateAt(DirectorCursor);
+			continue;
+		}
+
+		UpdateDirectorCandidate(Candidate, Time, DecayRate);
+		const float Score = Candidate.GetScore(Time, DecayRate);
+		if (Score > DirectorPassBestScore)
+		{
+			DirectorPassBest = Candidate.Actor;
+			DirectorPassBestScore = Score;
+		}
+
+		++DirectorCursor;
+		--Budget;
+	}
+}
+
+
+void ABasePlayerCameraManager::UpdateDirectorCandidate(FCameraDirectorCandidate& Candidate, const double Time, const float DecayRate)
+{
+	const ACharacterCameraLogic* CandidateCharacter = Cast<ACharacterCameraLogic>(Candidate.Actor.Get());
+	if (!CandidateCharacter) return;
+	Candidate.Location = CandidateCharacter->GetActorLocation();
+	MoveDirectorCandidateCell(Candidate, GetDirectorCell(Candidate.Location));
+
+	// The changes to the replicated state since the last visit are the events, damage is an event for both the player and who they hit
+	const FCameraDirectorState& State = CandidateCharacter->GetDirectorState();
+	const float Damage = FMath::Max(State.DamageTaken - Candidate.LastState.DamageTaken, 0.0f) + FMath::Max(State.DamageDealt - Candidate.LastState.DamageDealt, 0.0f);
+	if (Damage > 0.0f)
+	{
+		Candidate.AddEventInterest(Damage * DirectorDamageInterest, Time, DecayRate);
+	}
+
+	// Locking on to a new target is an event for both the player and their target
+	const int32 TargetLocks = State.TargetLocks - Candidate.LastState.TargetLocks;
+	if (TargetLocks > 0)
+	{
+		Candidate.AddEventInterest(DirectorTargetLockInterest * TargetLocks, Time, DecayRate);
+		if (const int32* TargetIndex = State.Target ? DirectorCandidateIndices.Find(State.Target.Get()) : nullptr)
+		{
+			DirectorCandidates[*TargetIndex].AddEventInterest(DirectorTargetLockInterest, Time, DecayRate);
+		}
+	}
+	Candidate.LastState = State;
+
+	// The other candidates' cells are from their last visit, which is at most a pass old
+	int32 NumCombatants = -1;
+	for (int32 Y = -1; Y <= 1; ++Y)
+	{
+		for (int32 X = -1; X <= 1; ++X)
+		{
+			const int32* CellCount = DirectorCellCounts.Find(Candidate.Cell + FIntPoint(X, Y));
+			NumCombatants += CellCount ? *CellCount : 0;
+		}
+	}
+
+	Candidate.StateInterest = DirectorCombatantInterest * (FMath::Max(NumCombatants, 0) + (State.bTargetLocking ? 1 : 0));
+}
+
+
+void ABasePlayerCameraManager::TrySwitchDirectorViewTarget(const double Time, const float DecayRate)
+{
+	AActor* Best = DirectorPassBest.Get();
+	AActor* Current = GetViewTarget();
+	if (!Best || Best == Current) return;
+
+	// Stay on the current player for the minimum shot duration, and until someone is clearly more interesting
+	const int32* CurrentIndex = DirectorCandidateIndices.Find(Current);
+	if (CurrentIndex)
+	{
+		if (Time - LastDirectorSwitchTime < DirectorMinShotDuration) return;
+
+		const float CurrentScore = DirectorCandidates[*CurrentIndex].GetScore(Time, DecayRate);
+		if (DirectorPassBestScore <= CurrentScore * (1.0f + DirectorSwitchMargin)) return;
+	}
+
+	LastDirectorSwitchTime = Time;
+	SwitchDirectorViewTarget(Best);
+}
+
+
+void ABasePlayerCameraManager::SwitchDirectorViewTarget(AActor* NewViewTarget)
+{
+	FViewTargetTransitionParams TransitionParams;
+	TransitionParams.BlendTime = DirectorBlendTime;
+	TransitionParams.BlendFunction = VTBlend_Cubic;
+	SetViewTarget(NewViewTarget, TransitionParams);
+}
+
+
+bool ABasePlayerCameraManager::IsDirectorCandidate(const AActor* Actor) const
+{
+	return IsValid(Actor) && Actor->IsA<ACharacterCameraLogic>() && (!PCOwner || Actor != PCOwner->GetPawn());
+}
+
+
+float ABasePlayerCameraManager::GetDirectorDecayRate() const
+{
+	return FMath::Loge(2.0f) / FMath::Max(DirectorInterestHalfLife, 0.1f);
+}
+
+
+void ABasePlayerCameraManager::OnDirectorActorSpawned(AActor* Actor)
+{
+	AddDirectorCandidate(Actor);
+}
+
+
+FIntPoint ABasePlayerCameraManager::GetDirectorCell(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt(Location.X / DirectorCellSize), FMath::FloorToInt(Location.Y / DirectorCellSize));
+}
+
+
+void ABasePlayerCameraManager::MoveDirectorCandidateCell(FCameraDirectorCandidate& Candidate, const FIntPoint& NewCell)
+{
+	if (NewCell == Candidate.Cell) return;
+
+	int32& OldCount = DirectorCellCounts.FindOrAdd(Candidate.Cell);
+	if (--OldCount <= 0) DirectorCellCounts.Remove(Candidate.Cell);
+	DirectorCellCounts.FindOrAdd(NewCell)++;
+	Candidate.Cell = NewCell;
+}
+#pragma endregion
+
+
+
+
+#pragma region Camera Shakes
+int32 ABasePlayerCameraManager::PlayProceduralShake(const FProceduralCameraShakeParams& Params, const float Scale)
+{
+	UCameraModifier_ProceduralShake* ShakeModifier = GetProceduralShakeModifier();
+	if (!ShakeModifier) return INDEX_NONE;
+	return ShakeModifier->PlayShake(Params, Scale);
+}
+
+
+int32 ABasePlayerCameraManager::PlayWorldProceduralShake(const FProceduralCameraShakeParams& Params, const FVector Epicenter, const float InnerRadius, const float OuterRadius, const float Falloff)
+{
+	float Scale = 1.0f;
+	const float Distance = FVector::Dist(Epicenter, GetCameraLocation());
+	if (OuterRadius > 0.0f && Distance > InnerRadius)
+	{
+		if (Distance >= OuterRadius) return INDEX_NONE;
+		const float Percent = (Distance - InnerRadius) / FMath::Max(OuterRadius - InnerRadius, UE_KINDA_SMALL_NUMBER);
+		Scale = 1.0f - FMath::Pow(FMath::Clamp(Percent, 0.0f, 1.0f), Falloff);
+	}
+
+	return PlayProceduralShake(Params, Scale);
+}
+
+
+void ABasePlayerCameraManager::StopProceduralShake(const int32 Handle, const bool bImmediately)
+{
+	if (ProceduralShakeModifier) ProceduralShakeModifier->StopShake(Handle, bImmediately);
+}
+
+
+void ABasePlayerCameraManager::StopAllProceduralShakes(const bool bImmediately)
+{
+	if (ProceduralShakeModifier) ProceduralShakeModifier->StopAllShakes(bImmediately);
+}
+
+
+UCameraModifier_ProceduralShake* ABasePlayerCameraManager::GetProceduralShakeModifier()
+{
+	if (!ProceduralShakeModifier)
+	{
+		ProceduralShakeModifier = Cast<UCameraModifier_ProceduralShake>(AddNewCameraModifier(UCameraModifier_ProceduralShake::StaticClass()));
+	}
+
+	return ProceduralShakeModifier;
+}
+#pragma endregion
+
+
 void ABasePlayerCameraManager::SetViewTarget(AActor* NewViewTarget, const FViewTargetTransitionParams TransitionParams)
 {
+	const AActor* PreviousViewTarget = PendingViewTarget.Target ? PendingViewTarget.Target : GetViewTarget();
 	Super::SetViewTarget(NewViewTarget, TransitionParams);
 
+	// Start spectating with a fresh view buffer instead of the views from the last time this player was watched
+	if (ACharacterCameraLogic* NewCharacter = Cast<ACharacterCameraLogic>(NewViewTarget); NewCharacter && NewCharacter != PreviousViewTarget)
+	{
+		NewCharacter->ResetSpectatorView();
+	}
+
 	if (NewViewTarget == nullptr)
 	{
 		NewViewTarget = PCOwner;
@@ -243,4 +1136,36 @@ void ABasePlayerCameraManager::SetViewTarget(AActor* NewViewTarget, const FViewT
 		CameraOrientation = ECameraOrientation::Center;
 		CameraStyle = CameraStyle_None;
 	}
+
+	TryRestoreRigSnapshot();
+}
+
+
+#pragma region Rig Snapshots
+bool ABasePlayerCameraManager::IsRigSnapshotCharacter(const ACharacterCameraLogic* InCharacter) const
+{
+	return IsValid(InCharacter) && PCOwner && PCOwner->IsLocalController() && InCharacter->GetController() == PCOwner;
+}
+
+
+void ABasePlayerCameraManager::TryRestoreRigSnapshot()
+{
+	if (!bWarmStartCameraRig || !RigSnapshot.bValid || !IsRigSnapshotCharacter(Character) || RigSnapshotCharacter.Get() == Character) return;
+
+	Character->RestoreCameraRigSnapshot(RigSnapshot);
+	RigSnapshotCharacter = Character;
+	CameraStyle = Character->Execute_GetCameraStyle(Character);
+	CameraOrientation = Character->Execute_GetCameraOrientation(Character);
+}
+
+
+UCameraRigSnapshotSubsystem* ABasePlayerCameraManager::GetRigSnapshotSubsystem(int32& OutControllerId) const
+{
+	const ULocalPlayer* LocalPlayer = PCOwner ? PCOwner->GetLocalPlayer() : nullptr;
+	const UGameInstance* GameInstance = GetGameInstance();
+	if (!LocalPlayer || !GameInstance) return nullptr;
+
+	OutControllerId = LocalPlayer->GetControllerId();
+	return GameInstance->GetSubsystem<UCameraRigSnapshotSubsystem>();
 }
+#pragma endregion
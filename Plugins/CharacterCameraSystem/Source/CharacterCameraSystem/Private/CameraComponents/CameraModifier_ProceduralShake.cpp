@@ -0,0 +1,200 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CameraComponents/CameraModifier_ProceduralShake.h"
+
+#include "PlayerCameraTypes.h"
+
+DECLARE_CYCLE_STAT(TEXT("Camera Procedural Shakes"), STAT_CameraProceduralShakes, STATGROUP_CharacterCamera);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Camera Procedural Shake Num"), STAT_CameraProceduralShakeNum, STATGROUP_CharacterCamera);
+
+/** The range of the random noise phases, which keeps the noise's input small enough for the hash to stay precise */
+static constexpr float MaxShakePhase = 256.0f;
+
+
+float FProceduralCameraShakeInstance::GetWeight() const
+{
+	float Weight = 1.0f;
+	if (BlendInTime > 0.0f && Time < BlendInTime) Weight = Time / BlendInTime;
+	if (Duration > 0.0f && BlendOutTime > 0.0f) Weight = FMath::Min(Weight, (Duration - Time) / BlendOutTime);
+	return FMath::Clamp(Weight, 0.0f, 1.0f);
+}
+
+
+UCameraModifier_ProceduralShake::UCameraModifier_ProceduralShake()
+{
+	Priority = 200;
+	NumShakes = 0;
+	NextHandle = 0;
+}
+
+
+bool UCameraModifier_ProceduralShake::ModifyCamera(const float DeltaTime, FMinimalViewInfo& InOutPOV)
+{
+	SCOPE_CYCLE_COUNTER(STAT_CameraProceduralShakes);
+	UpdateAlpha(DeltaTime);
+	AdvanceShakes(DeltaTime);
+	SET_DWORD_STAT(STAT_CameraProceduralShakeNum, NumShakes);
+	if (NumShakes == 0 || Alpha <= 0.0f) return false;
+
+	// Sum every shake's channels, four at a time
+	VectorRegister4Float LocationAndFOV = VectorZeroFloat();
+	VectorRegister4Float Rotation = VectorZeroFloat();
+	for (int32 Index = 0; Index < NumShakes; ++Index)
+	{
+		const FProceduralCameraShakeInstance& Shake = Shakes[Index];
+		const VectorRegister4Float Time = VectorSetFloat1(Shake.Time * Shake.Frequency);
+		const VectorRegister4Float Weight = VectorSetFloat1(Shake.GetWeight() * Shake.Scale);
+
+		const VectorRegister4Float LocationNoise = VectorMultiply(EvaluateNoise(Time, VectorLoad(Shake.Phase[0])), VectorLoad(Shake.Amplitude[0]));
+		const VectorRegister4Float RotationNoise = VectorMultiply(EvaluateNoise(Time, VectorLoad(Shake.Phase[1])), VectorLoad(Shake.Amplitude[1]));
+		LocationAndFOV = VectorMultiplyAdd(LocationNoise, Weight, LocationAndFOV);
+		Rotation = VectorMultiplyAdd(RotationNoise, Weight, Rotation);
+	}
+
+	float Offsets[2][4];
+	VectorStore(VectorMultiply(LocationAndFOV, VectorSetFloat1(Alpha)), Offsets[0]);
+	VectorStore(VectorMultiply(Rotation, VectorSetFloat1(Alpha)), Offsets[1]);
+
+	InOutPOV.Location += InOutPOV.Rotation.RotateVector(FVector(Offsets[0][0], Offsets[0][1], Offsets[0][2]));
+	InOutPOV.Rotation += FRotator(Offsets[1][0], Offsets[1][1], Offsets[1][2]);
+	InOutPOV.FOV += Offsets[0][3];
+	return false;
+}
+
+
+VectorRegister4Float UCameraModifier_ProceduralShake::EvaluateNoise(const VectorRegister4Float& Time, const VectorRegister4Float& Phase)
+{
+	// 1D gradient noise, with each lattice point's gradient hashed from it's position
+	const VectorRegister4Float X = VectorAdd(Time, Phase);
+	const VectorRegister4Float Cell = VectorFloor(X);
+	const VectorRegister4Float Fraction = VectorSubtract(X, Cell);
+
+	const VectorRegister4Float HashScale = VectorSetFloat1(12.9898f);
+	const VectorRegister4Float HashMagnitude = VectorSetFloat1(43758.5453f);
+	const VectorRegister4Float Gradient0 = VectorFractional(VectorMultiply(VectorSin(VectorMultiply(Cell, HashScale)), HashMagnitude));
+	const VectorRegister4Float Gradient1 = VectorFractional(VectorMultiply(VectorSin(VectorMultiply(VectorAdd(Cell, VectorOneFloat()), HashScale)), HashMagnitude));
+
+	const VectorRegister4Float Noise0 = VectorMultiply(Gradient0, Fraction);
+	const VectorRegister4Float Noise1 = VectorMultiply(Gradient1, VectorSubtract(Fraction, VectorOneFloat()));
+
+	// Smoothstep between the lattice points, the result is within -0.5 and 0.5 so it's doubled
+	const VectorRegister4Float Smooth = VectorMultiply(VectorMultiply(Fraction, Fraction), VectorSubtract(VectorSetFloat1(3.0f), VectorAdd(Fraction, Fraction)));
+	const VectorRegister4Float Noise = VectorMultiplyAdd(VectorSubtract(Noise1, Noise0), Smooth, Noise0);
+	return VectorAdd(Noise, Noise);
+}
+
+
+int32 UCameraModifier_ProceduralShake::PlayShake(const FProceduralCameraShakeParams& Params, const float Scale)
+{
+	if (Scale <= 0.0f) return INDEX_NONE;
+
+	// Replace the shake that's closest to finishing once the array is full
+	int32 Index = NumShakes;
+	if (NumShakes == MaxShakes)
+	{
+		float LeastRemaining = TNumericLimits<float>::Max();
+		for (int32 Other = 0; Other < NumShakes; ++Other)
+		{
+			const float Remaining = Shakes[Other].Duration > 0.0f ? Shakes[Other].Duration - Shakes[Other].Time : TNumericLimits<float>::Max();
+			if (Remaining < LeastRemaining)
+			{
+				LeastRemaining = Remaining;
+				Index = Other;
+			}
+		}
+
+		if (Index == NumShakes) Index = 0;
+	}
+	else
+	{
+		++NumShakes;
+	}
+
+	FProceduralCameraShakeInstance& Shake = Shakes[Index];
+	Shake = FProceduralCameraShakeInstance();
+	Shake.Duration = Params.Duration;
+	Shake.BlendInTime = Params.BlendInTime;
+	Shake.BlendOutTime = Params.BlendOutTime;
+	Shake.Frequency = Params.Frequency;
+	Shake.Scale = Scale;
+
+	Shake.Amplitude[0][0] = Params.LocationAmplitude.X;
+	Shake.Amplitude[0][1] = Params.LocationAmplitude.Y;
+	Shake.Amplitude[0][2] = Params.LocationAmplitude.Z;
+	Shake.Amplitude[0][3] = Params.FOVAmplitude;
+	Shake.Amplitude[1][0] = Params.RotationAmplitude.Pitch;
+	Shake.Amplitude[1][1] = Params.RotationAmplitude.Yaw;
+	Shake.Amplitude[1][2] = Params.RotationAmplitude.Roll;
+	Shake.Amplitude[1][3] = 0.0f;
+
+	// Each channel gets it's own phase so they don't move together
+	const FRandomStream Stream(Params.Seed != 0 ? Params.Seed : FMath::Rand());
+	for (int32 Group = 0; Group < 2; ++Group)
+	{
+		for (int32 Channel = 0; Channel < 4; ++Channel)
+		{
+			Shake.Phase[Group][Channel] = Stream.FRandRange(0.0f, MaxShakePhase);
+		}
+	}
+
+	NextHandle = NextHandle == MAX_int32 ? 1 : NextHandle + 1;
+	Shake.Handle = NextHandle;
+	return Shake.Handle;
+}
+
+
+void UCameraModifier_ProceduralShake::StopShake(const int32 Handle, const bool bImmediately)
+{
+	for (int32 Index = 0; Index < NumShakes; ++Index)
+	{
+		if (Shakes[Index].Handle != Handle) continue;
+
+		if (bImmediately)
+		{
+			RemoveShake(Index);
+			return;
+		}
+
+		FProceduralCameraShakeInstance& Shake = Shakes[Index];
+		const float StopTime = Shake.Time + Shake.BlendOutTime + UE_KINDA_SMALL_NUMBER;
+		Shake.Duration = Shake.Duration > 0.0f ? FMath::Min(Shake.Duration, StopTime) : StopTime;
+		return;
+	}
+}
+
+
+void UCameraModifier_ProceduralShake::StopAllShakes(const bool bImmediately)
+{
+	if (bImmediately)
+	{
+		NumShakes = 0;
+		return;
+	}
+
+	for (int32 Index = 0; Index < NumShakes; ++Index)
+	{
+		FProceduralCameraShakeInstance& Shake = Shakes[Index];
+		const float StopTime = Shake.Time + Shake.BlendOutTime + UE_KINDA_SMALL_NUMBER;
+		Shake.Duration = Shake.Duration > 0.0f ? FMath::Min(Shake.Duration, StopTime) : StopTime;
+	}
+}
+
+
+void UCameraModifier_ProceduralShake::AdvanceShakes(const float DeltaTime)
+{
+	for (int32 Index = NumShakes - 1; Index >= 0; --Index)
+	{
+		Shakes[Index].Time += DeltaTime;
+		if (Shakes[Index].IsFinished()) RemoveShake(Index);
+	}
+}
+
+
+void UCameraModifier_ProceduralShake::RemoveShake(const int32 Index)
+{
+	if (Index < 0 || Index >= NumShakes) return;
+
+	--NumShakes;
+	if (Index != NumShakes) Shakes[Index] = Shakes[NumShakes];
+}
@@ -0,0 +1,231 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CameraComponents/CameraRailActor.h"
+
+#include "PlayerCameraTypes.h"
+#include "Components/SplineComponent.h"
+
+DECLARE_CYCLE_STAT(TEXT("Camera Rail Evaluate"), STAT_CameraRailEvaluate, STATGROUP_CharacterCamera);
+DECLARE_CYCLE_STAT(TEXT("Camera Rail Build"), STAT_CameraRailBuild, STATGROUP_CharacterCamera);
+
+
+ACameraRailActor::ACameraRailActor()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	Rail = CreateDefaultSubobject<USplineComponent>(TEXT("Rail"));
+	SetRootComponent(Rail);
+
+	SampleSpacing = 50.0;
+	GridCellSize = 400.0;
+	TrackingDistance = 2000.0;
+	MaxGridCells = 16384;
+
+	LeadDistance = 0.0;
+	LookAtOffset = FVector(0.0, 0.0, 60.0);
+	FollowSpeed = 6.0;
+	FieldOfView = 0.0;
+
+	SampleStep = 0.0;
+	RailLength = 0.0;
+	bClosedLoop = false;
+	GridOrigin = FVector::ZeroVector;
+	GridCell = 0.0;
+	GridDimensions = FIntVector::ZeroValue;
+}
+
+
+void ACameraRailActor::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// This is built during play instead of construction, so editing the spline in the editor doesn't rebuild the grid each time it's moved
+	BuildLookupTables();
+}
+
+
+
+
+#pragma region Lookup Tables
+void ACameraRailActor::BuildLookupTables()
+{
+	SCOPE_CYCLE_COUNTER(STAT_CameraRailBuild);
+	Samples.Reset();
+	GridCellStarts.Reset();
+	GridSegments.Reset();
+
+	RailLength = Rail->GetSplineLength();
+	bClosedLoop = Rail->IsClosedLoop();
+	if (RailLength <= UE_KINDA_SMALL_NUMBER) return;
+
+	// The spline's own distance lookup is only used here, the camera's update just indexes into the samples
+	const int32 NumSegments = FMath::Max(FMath::CeilToInt(RailLength / FMath::Max(SampleSpacing, 1.0f)), 1);
+	SampleStep = RailLength / NumSegments;
+	Samples.SetNumUninitialized(NumSegments + 1);
+	for (int32 Index = 0; Index <= NumSegments; ++Index)
+	{
+		Samples[Index] = Rail->GetLocationAtDistanceAlongSpline(Index * SampleStep, ESplineCoordinateSpace::World);
+	}
+
+	BuildClosestPointGrid();
+}
+
+
+void ACameraRailActor::BuildClosestPointGrid()
+{
+	FBox Bounds(Samples);
+	Bounds = Bounds.ExpandBy(TrackingDistance);
+
+	// Grow the cells until the grid fits within the cell budget
+	const FVector Size = Bounds.GetSize();
+	GridCell = FMath::Max(GridCellSize, 10.0f);
+	const double NumCells = FMath::Max(FMath::CeilToDouble(Size.X / GridCell), 1.0) * FMath::Max(FMath::CeilToDouble(Size.Y / GridCell), 1.0) * FMath::Max(FMath::CeilToDouble(Size.Z / GridCell), 1.0);
+	if (NumCells > MaxGridCells)
+	{
+		GridCell *= FMath::Pow(NumCells / FMath::Max(MaxGridCells, 1), 1.0 / 3.0) * 1.01;
+	}
+
+	GridOrigin = Bounds.Min;
+	GridDimensions = FIntVector(
+		FMath::Max(FMath::CeilToInt(Size.X / GridCell), 1),
+		FMath::Max(FMath::CeilToInt(Size.Y / GridCell), 1),
+		FMath::Max(FMath::CeilToInt(Size.Z / GridCell), 1)
+	);
+
+	/**
+	 * For any point in a cell, the closest segment is at most a half diagonal further from the cell's center than the point is, and the point is at most a half diagonal
+	 * from the center. So every segment that's able to be closest is within the cell's closest distance plus the full diagonal of the center
+	 */
+	const int32 NumSegments = GetNumSegments();
+	const float Diagonal = FMath::Sqrt(3.0f) * GridCell;
+	TArray<float> SegmentDistances;
+	SegmentDistances.SetNumUninitialized(NumSegments);
+
+	const int32 TotalCells = GridDimensions.X * GridDimensions.Y * GridDimensions.Z;
+	GridCellStarts.SetNumUninitialized(TotalCells + 1);
+	for (int32 Z = 0; Z < GridDimensions.Z; ++Z)
+	{
+		for (int32 Y = 0; Y < GridDimensions.Y; ++Y)
+		{
+			for (int32 X = 0; X < GridDimensions.X; ++X)
+			{
+				const FVector Center = GridOrigin + (FVector(X, Y, Z) + 0.5) * GridCell;
+				float ClosestDistance = MAX_FLT;
+				for (int32 Segment = 0; Segment < NumSegments; ++Segment)
+				{
+					SegmentDistances[Segment] = FMath::Sqrt(FMath::PointDistToSegmentSquared(Center, Samples[Segment], Samples[Segment + 1]));
+					ClosestDistance = FMath::Min(ClosestDistance, SegmentDistances[Segment]);
+				}
+
+				GridCellStarts[(Z * GridDimensions.Y + Y) * GridDimensions.X + X] = GridSegments.Num();
+				for (int32 Segment = 0; Segment < NumSegments; ++Segment)
+				{
+					if (SegmentDistances[Segment] <= ClosestDistance + Diagonal)
+					{
+						GridSegments.Add(Segment);
+					}
+				}
+			}
+		}
+	}
+
+	GridCellStarts[TotalCells] = GridSegments.Num();
+}
+
+
+float ACameraRailActor::FindClosestDistance(const FVector& Location) const
+{
+	if (Samples.Num() < 2) return 0.0f;
+
+	const int32 Cell = GetGridCellIndex(Location);
+	float ClosestDistanceSquared = MAX_FLT;
+	float ClosestDistance = 0.0f;
+	for (int32 Index = GridCellStarts[Cell]; Index < GridCellStarts[Cell + 1]; ++Index)
+	{
+		const int32 Segment = GridSegments[Index];
+		const FVector& Start = Samples[Segment];
+		const FVector Direction = Samples[Segment + 1] - Start;
+		const float Alpha = FMath::Clamp(static_cast<float>(FVector::DotProduct(Location - Start, Direction) / FMath::Max(Direction.SizeSquared(), UE_SMALL_NUMBER)), 0.0f, 1.0f);
+		const float DistanceSquared = FVector::DistSquared(Location, Start + Direction * Alpha);
+		if (DistanceSquared < ClosestDistanceSquared)
+		{
+			ClosestDistanceSquared = DistanceSquared;
+			ClosestDistance = (Segment + Alpha) * SampleStep;
+		}
+	}
+
+	return ClosestDistance;
+}
+
+
+FVector ACameraRailActor::GetLocationAtDistance(float Distance) const
+{
+	if (Samples.IsEmpty()) return GetActorLocation();
+	if (Samples.Num() == 1) return Samples[0];
+
+	Distance = bClosedLoop ? FMath::Fmod(FMath::Fmod(Distance, RailLength) + RailLength, RailLength) : FMath::Clamp(Distance, 0.0f, RailLength);
+	const float Position = Distance / SampleStep;
+	const int32 Segment = FMath::Clamp(FMath::FloorToInt(Position), 0, GetNumSegments() - 1);
+	return FMath::Lerp(Samples[Segment], Samples[Segment + 1], Position - Segment);
+}
+
+
+int32 ACameraRailActor::GetGridCellIndex(const FVector& Location) const
+{
+	const FVector Local = (Location - GridOrigin) / GridCell;
+	const int32 X = FMath::Clamp(FMath::FloorToInt(Local.X), 0, GridDimensions.X - 1);
+	const int32 Y = FMath::Clamp(FMath::FloorToInt(Local.Y), 0, GridDimensions.Y - 1);
+	const int32 Z = FMath::Clamp(FMath::FloorToInt(Local.Z), 0, GridDimensions.Z - 1);
+	return (Z * GridDimensions.Y + Y) * GridDimensions.X + X;
+}
+
+
+int32 ACameraRailActor::GetNumSegments() const
+{
+	return FMath::Max(Samples.Num() - 1, 0);
+}
+
+
+int32 ACameraRailActor::GetLookupTableSize() const
+{
+	return Samples.GetAllocatedSize() + GridCellStarts.GetAllocatedSize() + GridSegments.GetAllocatedSize();
+}
+#pragma endregion
+
+
+
+
+#pragma region Camera
+void ACameraRailActor::EvaluateView(const FVector& ViewTargetLocation, const float DeltaTime, const bool bSnap, float& InOutDistance, FVector& OutLocation, FRotator& OutRotation) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_CameraRailEvaluate);
+
+	const float TargetDistance = FindClosestDistance(ViewTargetLocation);
+	if (bSnap || FollowSpeed <= 0.0f)
+	{
+		InOutDistance = TargetDistance;
+	}
+	else
+	{
+		// Follow the shortest way around closed loops, so crossing the start doesn't send the camera back around the whole rail
+		float Delta = TargetDistance - InOutDistance;
+		if (bClosedLoop && FMath::Abs(Delta) > RailLength * 0.5f)
+		{
+			Delta -= FMath::Sign(Delta) * RailLength;
+		}
+
+		InOutDistance = FMath::FInterpTo(InOutDistance, InOutDistance + Delta, DeltaTime, FollowSpeed);
+		if (bClosedLoop) InOutDistance = FMath::Fmod(InOutDistance + RailLength, RailLength);
+	}
+
+	OutLocation = GetLocationAtDistance(InOutDistance + LeadDistance);
+	OutRotation = (ViewTargetLocation + LookAtOffset - OutLocation).Rotation();
+}
+
+
+USplineComponent* ACameraRailActor::GetRail() const
+{
+	return Rail;
+}
+#pragma endregion
@@ -4,21 +4,101 @@
 #include "CameraComponents/TargetLockSpringArm.h"
 
 #include "Character/CharacterCameraLogic.h"
+#include "Subsystems/CameraRigSubsystem.h"
+#include "Data/CameraClearanceField.h"
+#include "Components/SkeletalMeshComponent.h"
 #include "PhysicsEngine/PhysicsSettings.h"
 
+/** How close a direction's Z has to be to straight up or down before it can't define the look rotation's yaw */
+static constexpr float LookRotationPoleThreshold = 0.998f;
+
+/** The angle a target transition has to be within before it's finished, in radians */
+static constexpr float TargetTransitionTolerance = UE_PI / 180.0f * 0.4f;
+
+
+void UTargetLockSpringArm::BeginPlay()
+{
+	Super::BeginPlay();
+
+	RigSubsystem = GetWorld() ? GetWorld()->GetSubsystem<UCameraRigSubsystem>() : nullptr;
+	if (bUseBatchedRigUpdate)
+	{
+		if (RigSubsystem)
+		{
+			RigSubsystem->RegisterRig(this);
+			SetComponentTickEnabled(false);
+			bRigBatched = true;
+		}
+	}
+}
+
+
+void UTargetLockSpringArm::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (bRigBatched)
+	{
+		if (RigSubsystem)
+		{
+			RigSubsystem->UnregisterRig(this);
+		}
+		bRigBatched = false;
+	}
+	RigSubsystem = nullptr;
+
+	Super::EndPlay(EndPlayReason);
+}
+
+
+void UTargetLockSpringArm::TickComponent(const float DeltaTime, const ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	// Activating the component re-enables it's tick, the batched update already handles this rig
+	if (bRigBatched) return;
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+}
+
 
 void UTargetLockSpringArm::UpdateDesiredArmLocation(bool bDoTrace, bool bDoLocationLag, bool bDoRotationLag, float DeltaTime)
 {
-	FRotator DesiredRotation = GetTargetRotation();
+	FCameraRigSettings Settings;
+	FCameraRigInput Input;
+	FCameraRigState State;
+	FCameraRigOutput Output;
+
+	GatherRig(bDoTrace, bDoLocationLag, bDoRotationLag, DeltaTime, Settings, Input, State);
+	SolveRig(Settings, Input, State, Output);
+	CommitRig(Input, State, Output);
+}
+
 
+#pragma region Rig Update
+void UTargetLockSpringArm::GatherRig(const bool bDoTrace, const bool bDoLocationLag, const bool bDoRotationLag, float DeltaTime, FCameraRigSettings& OutSettings, FCameraRigInput& OutInput, FCameraRigState& OutState)
+{
 	// If our ViewTarget is simulating using physics, we may need to clamp delta time
 	if (bClampToMaxPhysicsDeltaTime)
 	{
 		// Use the same max time step cap as the physics system to avoid camera jitter when the ViewTarget simulates less time than the camera
 		DeltaTime = FMath::Min(DeltaTime, UPhysicsSettings::Get()->MaxPhysicsDeltaTime);
 	}
-	
-	// If the player is target locking an enemy, update the rotation to face the target 
+
+	OutSettings.TargetArmLength = TargetArmLength;
+	OutSettings.SocketOffset = SocketOffset;
+	OutSettings.CameraLagSpeed = CameraLagSpeed;
+	OutSettings.CameraRotationLagSpeed = CameraRotationLagSpeed;
+	OutSettings.CameraLagMaxDistance = CameraLagMaxDistance;
+	OutSettings.CameraLagMaxTimeStep = CameraLagMaxTimeStep;
+	OutSettings.TargetLockTransitionSpeed = TargetLockTransitionSpeed;
+	OutSettings.bUseCameraLagSubstepping = bUseCameraLagSubstepping;
+
+	OutInput.ComponentLocation = GetComponentLocation();
+	OutInput.TargetOffset = TargetOffset;
+	OutInput.DesiredRotation = GetTargetRotation().Quaternion();
+	OutInput.DeltaTime = DeltaTime;
+	OutInput.bDoTrace = bDoTrace;
+	OutInput.bDoLocationLag = bDoLocationLag;
+	OutInput.bDoRotationLag = bDoRotationLag;
+	OutInput.bHasTarget = false;
+
+	// If the player is target locking an enemy, update the rotation to face the target
 	Character = Character ? Character : Cast<ACharacterCameraLogic>(GetOwner());
 	if (Character && Character->Execute_GetCameraStyle(Character) == CameraStyle_TargetLocking)
 	{
@@ -29,132 +109,225 @@ void UTargetLockSpringArm::UpdateDesiredArmLocation(bool bDoTrace, bool bDoLocat
 			CurrentTarget = Target;
 			bTargetTransition = true;
 		}
-		
+
 		if (CurrentTarget)
 		{
-			// If they just selected a target or are transitioning between targets we're going to add interpolation which is going to cause some lag until it finishes the transition
-			FVector TargetLocation = CurrentTarget->GetActorLocation() + TargetLockOffset;
-			FRotator TargetRotation = (TargetLocation - PreviousDesiredLoc).Rotation();
-			if (bTargetTransition)
-			{
-				DesiredRotation = FRotator(FMath::QInterpTo(FQuat(PreviousDesiredRot), FQuat(TargetRotation), DeltaTime, TargetLockTransitionSpeed));
-				if (DesiredRotation.Equals(TargetRotation, 0.4)) bTargetTransition = false;
-			}
-			else DesiredRotation = TargetRotation;
+			OutInput.TargetLocation = GetTargetLockAimLocation(CurrentTarget);
+			OutInput.bHasTarget = true;
+		}
+	}
 
-			// Also update the pawn control rotation to avoid drunken movement inputs from the character
-			AController* PlayerController = Character->GetController();
-			if (PlayerController)
-			{
-				// Character->SetActorRotation(DesiredRotation); // Vertical movement should be smoothed out here, otherwise this is going to mess up the players rotation
-				PlayerController->SetControlRotation(DesiredRotation);
-			}
+	OutState.PreviousDesiredLoc = PreviousDesiredLoc;
+	OutState.PreviousDesiredRot = PreviousDesiredQuat;
+	OutState.bTargetTransition = bTargetTransition;
+}
+
+
+void UTargetLockSpringArm::GatherSocketBlend(const float DeltaTime, FCameraRigSocketBlend& OutBlend)
+{
+	Character = Character ? Character : Cast<ACharacterCameraLogic>(GetOwner());
+	OutBlend.DeltaTime = DeltaTime;
+	OutBlend.bActive = false;
+
+	if (Character)
+	{
+		OutBlend.ArmBlend = Character->GetCameraArmBlend();
+		OutBlend.bActive = OutBlend.ArmBlend.IsActive();
+	}
+}
+
+
+void UTargetLockSpringArm::SolveRig(const FCameraRigSettings& Settings, const FCameraRigInput& Input, FCameraRigState& State, FCameraRigOutput& Output)
+{
+	const float DeltaTime = Input.DeltaTime;
+	FQuat DesiredRotation = Input.DesiredRotation;
+	Output.bUpdateControlRotation = false;
+
+	if (Input.bHasTarget)
+	{
+		// If they just selected a target or are transitioning between targets we're going to add interpolation which is going to cause some lag until it finishes the transition
+		const FQuat TargetRotation = MakeLookRotation(Input.TargetLocation - State.PreviousDesiredLoc, State.PreviousDesiredRot);
+		if (State.bTargetTransition)
+		{
+			DesiredRotation = FMath::QInterpTo(State.PreviousDesiredRot, TargetRotation, DeltaTime, Settings.TargetLockTransitionSpeed);
+			if (DesiredRotation.AngularDistance(TargetRotation) < TargetTransitionTolerance) State.bTargetTransition = false;
 		}
+		else DesiredRotation = TargetRotation;
+
+		// Also update the pawn control rotation to avoid drunken movement inputs from the character
+		Output.bUpdateControlRotation = true;
+		Output.ControlRotation = DesiredRotation;
 	}
 
 	// Apply 'lag' to rotation if desired
-	if(bDoRotationLag)
+	if (Input.bDoRotationLag)
 	{
-		if (bUseCameraLagSubstepping && DeltaTime > CameraLagMaxTimeStep && CameraRotationLagSpeed > 0.f)
+		if (Settings.bUseCameraLagSubstepping && DeltaTime > Settings.CameraLagMaxTimeStep && Settings.CameraRotationLagSpeed > 0.f)
 		{
-			const FRotator ArmRotStep = (DesiredRotation - PreviousDesiredRot).GetNormalized() * (1.f / DeltaTime);
-			FRotator LerpTarget = PreviousDesiredRot;
+			// The lag target moves along the shortest arc between the previous and desired rotations
+			const FQuat StartRotation = State.PreviousDesiredRot;
+			const FQuat EndRotation = DesiredRotation;
 			float RemainingTime = DeltaTime;
 			while (RemainingTime > UE_KINDA_SMALL_NUMBER)
 			{
-				const float LerpAmount = FMath::Min(CameraLagMaxTimeStep, RemainingTime);
-				LerpTarget += ArmRotStep * LerpAmount;
+				const float LerpAmount = FMath::Min(Settings.CameraLagMaxTimeStep, RemainingTime);
 				RemainingTime -= LerpAmount;
 
-				DesiredRotation = FRotator(FMath::QInterpTo(FQuat(PreviousDesiredRot), FQuat(LerpTarget), LerpAmount, CameraRotationLagSpeed));
-				PreviousDesiredRot = DesiredRotation;
+				const FQuat LerpTarget = FQuat::Slerp(StartRotation, EndRotation, 1.f - RemainingTime / DeltaTime);
+				DesiredRotation = FMath::QInterpTo(State.PreviousDesiredRot, LerpTarget, LerpAmount, Settings.CameraRotationLagSpeed);
+				State.PreviousDesiredRot = DesiredRotation;
 			}
 		}
 		else
 		{
-			DesiredRotation = FRotator(FMath::QInterpTo(FQuat(PreviousDesiredRot), FQuat(DesiredRotation), DeltaTime, CameraRotationLagSpeed));
+			DesiredRotation = FMath::QInterpTo(State.PreviousDesiredRot, DesiredRotation, DeltaTime, Settings.CameraRotationLagSpeed);
 		}
 	}
-	PreviousDesiredRot = DesiredRotation;
+	State.PreviousDesiredRot = DesiredRotation;
+
 
-	
 	// Get the spring arm 'origin', the target we want to look at
-	FVector ArmOrigin = GetComponentLocation() + TargetOffset;
+	const FVector ArmOrigin = Input.ComponentLocation + Input.TargetOffset;
 	// We lag the target, not the actual camera position, so rotating the camera around does not have lag
 	FVector DesiredLoc = ArmOrigin;
-	if (bDoLocationLag)
+	Output.bClampedDist = false;
+	if (Input.bDoLocationLag)
 	{
-		if (bUseCameraLagSubstepping && DeltaTime > CameraLagMaxTimeStep && CameraLagSpeed > 0.f)
+		if (Settings.bUseCameraLagSubstepping && DeltaTime > Settings.CameraLagMaxTimeStep && Settings.CameraLagSpeed > 0.f)
 		{
-			const FVector ArmMovementStep = (DesiredLoc - PreviousDesiredLoc) * (1.f / DeltaTime);
-			FVector LerpTarget = PreviousDesiredLoc;
+			const FVector ArmMovementStep = (DesiredLoc - State.PreviousDesiredLoc) * (1.f / DeltaTime);
+			FVector LerpTarget = State.PreviousDesiredLoc;
 
 			float RemainingTime = DeltaTime;
 			while (RemainingTime > UE_KINDA_SMALL_NUMBER)
 			{
-				const float LerpAmount = FMath::Min(CameraLagMaxTimeStep, RemainingTime);
+				const float LerpAmount = FMath::Min(Settings.CameraLagMaxTimeStep, RemainingTime);
 				LerpTarget += ArmMovementStep * LerpAmount;
 				RemainingTime -= LerpAmount;
 
-				DesiredLoc = FMath::VInterpTo(PreviousDesiredLoc, LerpTarget, LerpAmount, CameraLagSpeed);
-				PreviousDesiredLoc = DesiredLoc;
+				DesiredLoc = FMath::VInterpTo(State.PreviousDesiredLoc, LerpTarget, LerpAmount, Settings.CameraLagSpeed);
+				State.PreviousDesiredLoc = DesiredLoc;
 			}
 		}
 		else
 		{
-			DesiredLoc = FMath::VInterpTo(PreviousDesiredLoc, DesiredLoc, DeltaTime, CameraLagSpeed);
+			DesiredLoc = FMath::VInterpTo(State.PreviousDesiredLoc, DesiredLoc, DeltaTime, Settings.CameraLagSpeed);
 		}
 
 		// Clamp distance if requested
-		bool bClampedDist = false;
-		if (CameraLagMaxDistance > 0.f)
+		if (Settings.CameraLagMaxDistance > 0.f)
 		{
 			const FVector FromOrigin = DesiredLoc - ArmOrigin;
-			if (FromOrigin.SizeSquared() > FMath::Square(CameraLagMaxDistance))
+			if (FromOrigin.SizeSquared() > FMath::Square(Settings.CameraLagMaxDistance))
 			{
-				DesiredLoc = ArmOrigin + FromOrigin.GetClampedToMaxSize(CameraLagMaxDistance);
-				bClampedDist = true;
+				DesiredLoc = ArmOrigin + FromOrigin.GetClampedToMaxSize(Settings.CameraLagMaxDistance);
+				Output.bClampedDist = true;
 			}
-		}		
-
-		#if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
-		if (bDrawDebugLagMarkers)
-		{
-			DrawDebugSphere(GetWorld(), ArmOrigin, 5.f, 8, FColor::Green);
-			DrawDebugSphere(GetWorld(), DesiredLoc, 5.f, 8, FColor::Yellow);
-
-			const FVector ToOrigin = ArmOrigin - DesiredLoc;
-			DrawDebugDirectionalArrow(GetWorld(), DesiredLoc, DesiredLoc + ToOrigin * 0.5f, 7.5f, bClampedDist ? FColor::Red : FColor::Green);
-			DrawDebugDirectionalArrow(GetWorld(), DesiredLoc + ToOrigin * 0.5f, ArmOrigin,  7.5f, bClampedDist ? FColor::Red : FColor::Green);
 		}
-		#endif
 	}
 
-	PreviousArmOrigin = ArmOrigin;
-	PreviousDesiredLoc = DesiredLoc;
+	State.PreviousDesiredLoc = DesiredLoc;
+	Output.ArmOrigin = ArmOrigin;
+	Output.LaggedLocation = DesiredLoc;
 
-	
 	// Now offset camera position back along our rotation
-	DesiredLoc -= DesiredRotation.Vector() * TargetArmLength;
+	DesiredLoc -= DesiredRotation.GetForwardVector() * Settings.TargetArmLength;
 	// Add socket offset in local space
-	DesiredLoc += FRotationMatrix(DesiredRotation).TransformVector(SocketOffset);
+	DesiredLoc += DesiredRotation.RotateVector(Settings.SocketOffset);
+
+	Output.DesiredLoc = DesiredLoc;
+	Output.DesiredRotation = DesiredRotation;
+}
+
+
+FQuat UTargetLockSpringArm::MakeLookRotation(const FVector& Direction, const FQuat& PreviousRotation)
+{
+	const FVector Forward = Direction.GetSafeNormal();
+	if (Forward.IsZero()) return PreviousRotation;
+
+	// Near the poles the world up can't define the yaw, so the previous rotation's right vector is used to keep it
+	if (FMath::Abs(Forward.Z) > LookRotationPoleThreshold)
+	{
+		return FRotationMatrix::MakeFromXY(Forward, PreviousRotation.GetRightVector()).ToQuat();
+	}
+
+	return FRotationMatrix::MakeFromXZ(Forward, FVector::UpVector).ToQuat();
+}
+
+
+void FCameraRigSocketBlend::Solve()
+{
+	if (!bActive) return;
+
+	ArmBlend.Advance(DeltaTime);
+	const FCameraArmConfiguration Configuration = ArmBlend.Evaluate();
+	SocketOffset = FVector(Configuration.Offset.X, Configuration.Offset.Y, 0);
+	TargetOffset = FVector(0, 0, Configuration.Offset.Z);
+	TargetArmLength = Configuration.ArmLength;
+	CameraLagSpeed = Configuration.LagSpeed;
+	bEnableCameraLag = Configuration.bEnableCameraLag;
+}
+
+
+void UTargetLockSpringArm::CommitSocketBlend(const FCameraRigSocketBlend& Blend)
+{
+	if (!Blend.bActive) return;
+
+	SocketOffset = Blend.SocketOffset;
+	TargetOffset = Blend.TargetOffset;
+	TargetArmLength = Blend.TargetArmLength;
+	CameraLagSpeed = Blend.CameraLagSpeed;
+	bEnableCameraLag = Blend.bEnableCameraLag;
+	if (Character) Character->SetCameraArmBlend(Blend.ArmBlend);
+}
+
+
+void UTargetLockSpringArm::CommitRig(const FCameraRigInput& Input, const FCameraRigState& State, const FCameraRigOutput& Output)
+{
+	PreviousDesiredQuat = State.PreviousDesiredRot;
+	PreviousDesiredLoc = State.PreviousDesiredLoc;
+	PreviousArmOrigin = Output.ArmOrigin;
+	bTargetTransition = State.bTargetTransition;
+
+	if (Output.bUpdateControlRotation && Character)
+	{
+		AController* PlayerController = Character->GetController();
+		if (PlayerController)
+		{
+			// Character->SetActorRotation(DesiredRotation); // Vertical movement should be smoothed out here, otherwise this is going to mess up the players rotation
+			PlayerController->SetControlRotation(Output.ControlRotation.Rotator());
+		}
+	}
+
+	#if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+	if (Input.bDoLocationLag && bDrawDebugLagMarkers)
+	{
+		const FVector& ArmOrigin = Output.ArmOrigin;
+		const FVector& DesiredLoc = Output.LaggedLocation;
+		DrawDebugSphere(GetWorld(), ArmOrigin, 5.f, 8, FColor::Green);
+		DrawDebugSphere(GetWorld(), DesiredLoc, 5.f, 8, FColor::Yellow);
+
+		const FVector ToOrigin = ArmOrigin - DesiredLoc;
+		DrawDebugDirectionalArrow(GetWorld(), DesiredLoc, DesiredLoc + ToOrigin * 0.5f, 7.5f, Output.bClampedDist ? FColor::Red : FColor::Green);
+		DrawDebugDirectionalArrow(GetWorld(), DesiredLoc + ToOrigin * 0.5f, ArmOrigin,  7.5f, Output.bClampedDist ? FColor::Red : FColor::Green);
+	}
+	#endif
 
 	// Do a sweep to ensure we are not penetrating the world
+	const FVector& DesiredLoc = Output.DesiredLoc;
 	FVector ResultLoc;
-	if (bDoTrace && (TargetArmLength != 0.0f))
+	if (Input.bDoTrace && (TargetArmLength != 0.0f))
 	{
 		bIsCameraFixed = true;
-		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(SpringArm), false, GetOwner());
+		FVector HitLocation;
+		const bool bBlocked = SweepArm(Output.ArmOrigin, DesiredLoc, HitLocation);
 
-		FHitResult Result;
-		GetWorld()->SweepSingleByChannel(Result, ArmOrigin, DesiredLoc, FQuat::Identity, ProbeChannel, FCollisionShape::MakeSphere(ProbeSize), QueryParams);
-		
 		UnfixedCameraPosition = DesiredLoc;
 
-		ResultLoc = BlendLocations(DesiredLoc, Result.Location, Result.bBlockingHit, DeltaTime);
+		ResultLoc = BlendLocations(DesiredLoc, HitLocation, bBlocked, Input.DeltaTime);
 
-		if (ResultLoc == DesiredLoc) 
-		{	
+		if (ResultLoc == DesiredLoc)
+		{
 			bIsCameraFixed = false;
 		}
 	}
@@ -165,8 +338,10 @@ void UTargetLockSpringArm::UpdateDesiredArmLocation(bool bDoTrace, bool bDoLocat
 		UnfixedCameraPosition = ResultLoc;
 	}
 
+	CollisionAdjustedArmLength = FVector::Dist(Output.ArmOrigin, ResultLoc);
+
 	// Form a transform for new world transform for camera
-	FTransform WorldCamTM(DesiredRotation, ResultLoc);
+	FTransform WorldCamTM(Output.DesiredRotation, ResultLoc);
 	// Convert to relative to component
 	FTransform RelCamTM = WorldCamTM.GetRelativeTransform(GetComponentTransform());
 
@@ -175,7 +350,7 @@ void UTargetLockSpringArm::UpdateDesiredArmLocation(bool bDoTrace, bool bDoLocat
 	RelativeSocketRotation = RelCamTM.GetRotation();
 
 	UpdateChildTransforms();
-	
+
 	if (Character && Character->Execute_GetCameraStyle(Character) != CameraStyle_TargetLocking)
 	{
 		CurrentTarget = nullptr;
@@ -184,7 +359,162 @@ void UTargetLockSpringArm::UpdateDesiredArmLocation(bool bDoTrace, bool bDoLocat
 }
 
 
+bool UTargetLockSpringArm::SweepArm(const FVector& ArmOrigin, const FVector& DesiredLoc, FVector& OutHitLocation) const
+{
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(SpringArm), false, GetOwner());
+	const FCollisionShape Probe = FCollisionShape::MakeSphere(ProbeSize);
+	FHitResult Result;
+
+	// The static geometry's clearance is baked, so only the movable objects need to be swept up to the clearance
+	const UCameraClearanceField* ClearanceField = bUseClearanceField && RigSubsystem ? RigSubsystem->GetClearanceField(ArmOrigin) : nullptr;
+	const FVector ToCamera = DesiredLoc - ArmOrigin;
+	const float ArmLength = ToCamera.Size();
+	float MaxArmLength;
+	if (ClearanceField && ArmLength > UE_KINDA_SMALL_NUMBER && ClearanceField->GetMaxArmLength(ArmOrigin, ToCamera / ArmLength, MaxArmLength)
+		&& (MaxArmLength < ClearanceField->MaxArmLength || ArmLength <= ClearanceField->MaxArmLength))
+	{
+		const bool bStaticBlock = ArmLength > MaxArmLength;
+		const FVector ClearLoc = bStaticBlock ? ArmOrigin + ToCamera * (MaxArmLength / ArmLength) : DesiredLoc;
+
+		QueryParams.MobilityType = EQueryMobilityType::Dynamic;
+		GetWorld()->SweepSingleByChannel(Result, ArmOrigin, ClearLoc, FQuat::Identity, ProbeChannel, Probe, QueryParams);
+		OutHitLocation = Result.bBlockingHit ? Result.Location : ClearLoc;
+		return Result.bBlockingHit || bStaticBlock;
+	}
+
+	GetWorld()->SweepSingleByChannel(Result, ArmOrigin, DesiredLoc, FQuat::Identity, ProbeChannel, Probe, QueryParams);
+	OutHitLocation = Result.Location;
+	return Result.bBlockingHit;
+}
+#pragma endregion
+
+
 void UTargetLockSpringArm::UpdateTargetLockOffset(FVector Offset)
 {
 	TargetLockOffset = Offset;
 }
+
+
+FVector UTargetLockSpringArm::GetTargetLockAimLocation(const AActor* Target)
+{
+	if (!Target) return FVector::ZeroVector;
+	if (!bUseTargetLockAimPoint) return Target->GetActorLocation() + TargetLockOffset;
+
+	// Lazily resolve the aim point, the socket and bounds lookups are too expensive to do every frame
+	const double Time = GetWorld() ? GetWorld()->GetTimeSeconds() : 0.0;
+	FTargetLockAimPoint* AimPoint = AimPointCache.Find(Target);
+	if (!AimPoint || Time - AimPoint->ResolveTime > AimPointRefreshInterval)
+	{
+		// Only a handful of recent targets are kept, the stale ones are dropped first and then the least recently resolved one
+		if (!AimPoint && AimPointCache.Num() >= MaxCachedAimPoints)
+		{
+			for (auto It = AimPointCache.CreateIterator(); It; ++It)
+			{
+				if (Time - It.Value().ResolveTime > AimPointRefreshInterval) It.RemoveCurrent();
+			}
+
+			if (AimPointCache.Num() >= MaxCachedAimPoints)
+			{
+				TObjectKey<AActor> OldestTarget;
+				double OldestResolveTime = TNumericLimits<double>::Max();
+				for (const TPair<TObjectKey<AActor>, FTargetLockAimPoint>& CachedAimPoint : AimPointCache)
+				{
+					if (CachedAimPoint.Value.ResolveTime < OldestResolveTime)
+					{
+						OldestTarget = CachedAimPoint.Key;
+						OldestResolveTime = CachedAimPoint.Value.ResolveTime;
+					}
+				}
+
+				AimPointCache.Remove(OldestTarget);
+			}
+		}
+
+		AimPoint = &AimPointCache.FindOrAdd(Target);
+		AimPoint->LocalOffset = ResolveTargetAimOffset(Target);
+		AimPoint->ResolveTime = Time;
+	}
+
+	const FTransform& TargetTransform = Target->GetActorTransform();
+	FVector AimLocation = TargetTransform.GetLocation() + TargetTransform.GetRotation().RotateVector(AimPoint->LocalOffset);
+
+	// Predict where the target is going to be once the camera catches up to it
+	if (AimPredictionTime > 0.0f)
+	{
+		AimLocation += (Target->GetVelocity() * AimPredictionTime).GetClampedToMaxSize(MaxAimPredictionDistance);
+	}
+
+	return AimLocation;
+}
+
+
+FVector UTargetLockSpringArm::ResolveTargetAimOffset(const AActor* Target) const
+{
+	if (!Target) return FVector::ZeroVector;
+	const FTransform& TargetTransform = Target->GetActorTransform();
+
+	if (!TargetLockAimSocket.IsNone())
+	{
+		const USkeletalMeshComponent* Mesh = Target->FindComponentByClass<USkeletalMeshComponent>();
+		if (Mesh && Mesh->DoesSocketExist(TargetLockAimSocket))
+		{
+			return TargetTransform.InverseTransformVectorNoScale(Mesh->GetSocketLocation(TargetLockAimSocket) - TargetTransform.GetLocation());
+		}
+	}
+
+	FVector Origin;
+	FVector Extent;
+	Target->GetActorBounds(true, Origin, Extent);
+	const FVector AimPoint = Origin + FVector(0.0, 0.0, Extent.Z * (TargetLockAimBoundsHeight * 2.0 - 1.0));
+	return TargetTransform.InverseTransformVectorNoScale(AimPoint - TargetTransform.GetLocation());
+}
+
+
+void UTargetLockSpringArm::CaptureRigSnapshot(FCameraRigSnapshot& OutSnapshot) const
+{
+	const FQuat Frame = GetTargetRotation().Quaternion();
+	const FVector Origin = GetComponentLocation();
+	OutSnapshot.RelativeDesiredLoc = Frame.UnrotateVector(PreviousDesiredLoc - Origin);
+	OutSnapshot.RelativeArmOrigin = Frame.UnrotateVector(PreviousArmOrigin - Origin);
+	OutSnapshot.RotationLag = Frame.Inverse() * PreviousDesiredQuat;
+}
+
+
+void UTargetLockSpringArm::RestoreRigSnapshot(const FCameraRigSnapshot& Snapshot)
+{
+	const FQuat Frame = GetTargetRotation().Quaternion();
+	const FVector Origin = GetComponentLocation();
+	PreviousDesiredLoc = Origin + Frame.RotateVector(Snapshot.RelativeDesiredLoc);
+	PreviousArmOrigin = Origin + Frame.RotateVector(Snapshot.RelativeArmOrigin);
+	PreviousDesiredQuat = Frame * Snapshot.RotationLag;
+	PreviousDesiredRot = PreviousDesiredQuat.Rotator();
+
+	// The new pawn's target is picked up again by the next update
+	CurrentTarget = nullptr;
+	bTargetTransition = false;
+}
+
+
+float UTargetLockSpringArm::GetCollisionAdjustedArmLength() const
+{
+	return CollisionAdjustedArmLength < 0.0f ? TargetArmLength : CollisionAdjustedArmLength;
+}
+
+
+bool UTargetLockSpringArm::IsRigBatched() const
+{
+	return bRigBatched;
+}
+
+
+SIZE_T UTargetLockSpringArm::GetAllocatedRigSize() const
+{
+	return AimPointCache.GetAllocatedSize();
+}
+
+
+void UTargetLockSpringArm::GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize)
+{
+	Super::GetResourceSizeEx(CumulativeResourceSize);
+	CumulativeResourceSize.AddDedicatedSystemMemoryBytes(GetAllocatedRigSize());
+}
@@ -4,13 +4,34 @@
 #include "Character/CharacterCameraLogic.h"
 
 #include "Camera/CameraComponent.h"
+#include "CameraComponents/BasePlayerCameraManager.h"
 #include "CameraComponents/TargetLockSpringArm.h"
+#include "Debug/CameraNetProfiler.h"
+#include "Subsystems/CameraSignificanceSubsystem.h"
+#include "Subsystems/CameraTargetingSubsystem.h"
+#include "Components/MeshComponent.h"
 #include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/GameStateBase.h"
 #include "Kismet/KismetMathLibrary.h"
 #include "Logging/StructuredLog.h"
+#include "Net/UnrealNetwork.h"
 
 DEFINE_LOG_CATEGORY(CameraLog);
 
+static TAutoConsoleVariable<float> CVarSpectatorCheckInterval(
+	TEXT("Camera.Spectator.CheckInterval"),
+	0.5f,
+	TEXT("How often the server checks whether each camera character is being spectated, in seconds. Characters only send their view while they're being spectated"),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<int32> CVarCameraMemoryBudget(
+	TEXT("Camera.Memory.Budget"),
+	0,
+	TEXT("The most memory the camera system is allowed to add to a character, in bytes. Characters over the budget log an error once they begin play. Zero disables the check"),
+	ECVF_Default
+);
+
 
 ACharacterCameraLogic::ACharacterCameraLogic(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
@@ -47,6 +68,113 @@ ACharacterCameraLogic::ACharacterCameraLogic(const FObjectInitializer& ObjectIni
 	CameraOffset_Right = FVector(0.0, 64.0, 100.0);
 
 	TargetLockTransitionSpeed = 6.4;
+
+	// Camera events
+	bCoalesceCameraEvents = true;
+	PendingCameraEvents = ECameraEventFlags::None;
+	FlushedCameraStyle = CameraStyle_None;
+	FlushedCameraOrientation = ECameraOrientation::None;
+
+	// Target re-evaluation
+	TargetLockBreakDistance = 1200.0;
+	TargetSwitchScoreMargin = 0.25;
+	TargetAngleScoreWeight = 1.0;
+	TargetDistanceScoreWeight = 0.5;
+
+	// Spectator view
+	bReplicateSpectatorView = true;
+	SpectatorViewRate = 10.0;
+	SpectatorViewKeyframeInterval = 1.0;
+	SpectatorViewInterpolationDelay = 0.25;
+	bIsBeingSpectated = false;
+	bHasSpectators = false;
+#if WITH_CAMERA_NET_PROFILER
+	bRecordedIsBeingSpectated = false;
+#endif
+	NextSpectatorViewTime = 0.0;
+	NextSpectatorKeyframeTime = 0.0;
+	NextSpectatorCheckTime = 0.0;
+
+	// Near camera fade
+	bUseNearCameraFade = false;
+	NearCameraHideDistance = 40.0;
+	NearCameraFadeDistance = 120.0;
+	NearCameraHysteresis = 15.0;
+	NearCameraFadeDataIndex = 0;
+	NearCameraFade = 1.0;
+	bNearCameraHidden = false;
+
+	// Camera view history
+	bRecordCameraViewHistory = false;
+	CameraViewHistoryRate = 20.0;
+	CameraViewHistoryMaxDistance = 2000.0;
+	NextCameraViewHistoryTime = 0.0;
+}
+
+
+void ACharacterCameraLogic::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+	BuildCameraArmTable();
+}
+
+
+void ACharacterCameraLogic::GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize)
+{
+	Super::GetResourceSizeEx(CumulativeResourceSize);
+
+	// The components report their own allocations
+	FCameraMemoryBreakdown Breakdown;
+	GetCameraMemoryBreakdown(Breakdown);
+	for (int32 Category = 0; Category < FCameraMemoryBreakdown::NumCategories; ++Category)
+	{
+		if (Category != FCameraMemoryBreakdown::Components)
+		{
+			CumulativeResourceSize.AddDedicatedSystemMemoryBytes(Breakdown.Allocated[Category]);
+		}
+	}
+}
+
+
+void ACharacterCameraLogic::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+	DOREPLIFETIME_CONDITION(ACharacterCameraLogic, bIsBeingSpectated, COND_OwnerOnly);
+	DOREPLIFETIME_CONDITION(ACharacterCameraLogic, SpectatorView, COND_SkipOwner);
+	DOREPLIFETIME_CONDITION(ACharacterCameraLogic, DirectorState, COND_SkipOwner);
+}
+
+
+void ACharacterCameraLogic::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker)
+{
+	Super::PreReplication(ChangedPropertyTracker);
+
+	// Property conditions can't tell which connections are spectating, so the view is only sent to the other players while anyone is
+	DOREPLIFETIME_ACTIVE_OVERRIDE(ACharacterCameraLogic, SpectatorView, bIsBeingSpectated);
+
+	// Only spectators run the director, the players don't need each other's director state
+	DOREPLIFETIME_ACTIVE_OVERRIDE(ACharacterCameraLogic, DirectorState, bHasSpectators);
+
+#if WITH_CAMERA_NET_PROFILER
+	// The properties are replicated when they've changed, so they're recorded as sent once for each change
+	if (bRecordedIsBeingSpectated != bIsBeingSpectated)
+	{
+		bRecordedIsBeingSpectated = bIsBeingSpectated;
+		CAMERA_NET_RECORD_REPLICATED(this, GET_MEMBER_NAME_CHECKED(ACharacterCameraLogic, bIsBeingSpectated), COND_OwnerOnly, sizeof(uint8));
+	}
+
+	if (bIsBeingSpectated && RecordedSpectatorView != SpectatorView)
+	{
+		RecordedSpectatorView = SpectatorView;
+		CAMERA_NET_RECORD_REPLICATED(this, GET_MEMBER_NAME_CHECKED(ACharacterCameraLogic, SpectatorView), COND_SkipOwner, FSpectatorViewSample::EstimatedNetSize);
+	}
+
+	if (bHasSpectators && RecordedDirectorState != DirectorState)
+	{
+		RecordedDirectorState = DirectorState;
+		CAMERA_NET_RECORD_REPLICATED(this, GET_MEMBER_NAME_CHECKED(ACharacterCameraLogic, DirectorState), COND_SkipOwner, FCameraDirectorState::EstimatedNetSize);
+	}
+#endif
 }
 
 
@@ -57,6 +185,50 @@ void ACharacterCameraLogic::BeginPlay()
 	OnCameraStyleSet();
 	OnCameraOrientationSet();
 	SetTargetLockTransitionSpeed(TargetLockTransitionSpeed);
+	FlushCameraEvents();
+	RefreshNearCameraPrimitives();
+
+#if !UE_BUILD_SHIPPING
+	CheckCameraMemoryBudget();
+#endif
+
+	if (HasAuthority())
+	{
+		OnTakeAnyDamage.AddUniqueDynamic(this, &ACharacterCameraLogic::OnDirectorStateDamaged);
+	}
+
+	UpdateCameraSignificanceRegistration();
+}
+
+
+void ACharacterCameraLogic::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UCameraTargetingSubsystem* TargetingSubsystem = GetWorld() ? GetWorld()->GetSubsystem<UCameraTargetingSubsystem>() : nullptr)
+	{
+		TargetingSubsystem->UnregisterTargetReevaluation(this);
+	}
+
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickFlushHandle);
+	PostActorTickFlushHandle.Reset();
+	Super::EndPlay(EndPlayReason);
+}
+
+
+void ACharacterCameraLogic::NotifyControllerChanged()
+{
+	Super::NotifyControllerChanged();
+	if (HasActorBegunPlay()) UpdateCameraSignificanceRegistration();
+}
+
+
+void ACharacterCameraLogic::UpdateCameraSignificanceRegistration()
+{
+	UCameraSignificanceSubsystem* SignificanceSubsystem = GetWorld() ? GetWorld()->GetSubsystem<UCameraSignificanceSubsystem>() : nullptr;
+	if (!bUseCameraSignificance || !SignificanceSubsystem) return;
+
+	// The local player's own character is always updated every frame
+	if (IsLocallyControlled()) SignificanceSubsystem->UnregisterActor(this);
+	else SignificanceSubsystem->RegisterActor(this);
 }
 
 
@@ -70,11 +242,20 @@ void ACharacterCameraLogic::SetupPlayerInputComponent(UInputComponent* PlayerInp
 void ACharacterCameraLogic::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
+	FlushCameraEvents();
 
-	if (TargetOffset != CameraArm->SocketOffset)
+	// Batched rigs handle the arm transitions in the camera rig subsystem
+	if (!CameraArm->IsRigBatched() && CameraArmBlend.IsActive())
 	{
-		UpdateCameraSocketLocation(TargetOffset, DeltaTime);
+		UpdateCameraArmBlend(DeltaTime);
 	}
+
+	UpdateNearCameraFade();
+	TryReportCameraFOV();
+	UpdateSpectatedState();
+	UpdateDirectorState();
+	TryReportSpectatorView();
+	TryReportCameraViewHistory();
 }
 
 
@@ -87,11 +268,17 @@ void ACharacterCameraLogic::SetCameraStyle_Implementation(const FName Style)
 	{
 		CameraStyle = Style;
 		Server_SetCameraStyle(Style);
+		CAMERA_NET_RECORD(this, GET_FUNCTION_NAME_CHECKED(ACharacterCameraLogic, Server_SetCameraStyle), ECameraNetEvent::Sent, FCameraNetProfiler::RpcHeaderSize + FCameraNetProfiler::EstimateNameSize(Style));
+	}
+	else
+	{
+		CAMERA_NET_RECORD(this, GET_FUNCTION_NAME_CHECKED(ACharacterCameraLogic, Server_SetCameraStyle), ECameraNetEvent::Throttled, 0);
 	}
 }
 
 void ACharacterCameraLogic::Server_SetCameraStyle_Implementation(const FName Style)
 {
+	CAMERA_NET_RECORD(this, GET_FUNCTION_NAME_CHECKED(ACharacterCameraLogic, Server_SetCameraStyle), ECameraNetEvent::Received, FCameraNetProfiler::RpcHeaderSize + FCameraNetProfiler::EstimateNameSize(Style));
 	// TODO: add logic to prevent spamming
 	CameraStyle = Style;
 	OnCameraStyleSet();
@@ -117,23 +304,14 @@ bool ACharacterCameraLogic::IsAbleToActivateCameraTransition()
 
 void ACharacterCameraLogic::OnCameraStyleSet()
 {
-	if (CameraStyle == CameraStyle_FirstPerson)
+	// The target lock is also updated in case it was or is transitioning to target locking
+	if (bCoalesceCameraEvents)
 	{
-		SetRotationToCamera();
-		UpdateCameraArmSettings(CameraOffset_FirstPerson, 0, false);
-	}
-	else if (CameraStyle == CameraStyle_TargetLocking)
-	{
-		SetRotationToMovement();
-		UpdateCameraArmSettings(GetCameraOffset(Execute_GetCameraStyle(this), Execute_GetCameraOrientation(this)), TargetArmLength, true, CameraLag);
-	}
-	else if (CameraStyle == CameraStyle_ThirdPerson)
-	{
-		SetRotationToMovement();
-		UpdateCameraArmSettings(GetCameraOffset(Execute_GetCameraStyle(this), Execute_GetCameraOrientation(this)), TargetArmLength, true, CameraLag);
+		MarkCameraEventsDirty(ECameraEventFlags::Style | ECameraEventFlags::Target);
+		return;
 	}
 
-	// If was or is transitioning to target locking
+	ApplyCameraStyle();
 	OnTargetLockCharacterUpdated();
 
 	if (bDebugCameraStyle)
@@ -148,6 +326,18 @@ void ACharacterCameraLogic::OnCameraStyleSet()
 }
 
 
+void ACharacterCameraLogic::ApplyCameraStyle()
+{
+	FCameraArmConfiguration Configuration;
+	ECameraRotationMode RotationMode;
+	if (!FindCameraArmConfiguration(CameraStyle, CameraOrientation, Configuration, RotationMode)) return;
+
+	if (RotationMode == ECameraRotationMode::ToCamera) SetRotationToCamera();
+	else if (RotationMode == ECameraRotationMode::ToMovement) SetRotationToMovement();
+	BlendToArmConfiguration(Configuration);
+}
+
+
 void ACharacterCameraLogic::SetCameraOrientation_Implementation(const ECameraOrientation Orientation)
 {
 	CameraOrientation = Orientation;
@@ -157,20 +347,13 @@ void ACharacterCameraLogic::SetCameraOrientation_Implementation(const ECameraOri
 
 void ACharacterCameraLogic::OnCameraOrientationSet()
 {
-	FVector CameraLocation = CameraOffset_FirstPerson;
-	float ArmLength = 0;
-	bool bEnableCameraLag = false;
-	float LagSpeed = 0;
-
-	if (CameraStyle == CameraStyle_ThirdPerson || CameraStyle == CameraStyle_TargetLocking)
+	if (bCoalesceCameraEvents)
 	{
-		CameraLocation = GetCameraOffset(CameraStyle, CameraOrientation);
-		ArmLength = TargetArmLength;
-		bEnableCameraLag = true;
-		LagSpeed = CameraLag;
+		MarkCameraEventsDirty(ECameraEventFlags::Orientation);
+		return;
 	}
-	
-	UpdateCameraArmSettings(CameraLocation, ArmLength, bEnableCameraLag, LagSpeed);
+
+	ApplyCameraOrientation();
 
 	if (bDebugCameraOrientation)
 	{
@@ -184,6 +367,16 @@ void ACharacterCameraLogic::OnCameraOrientationSet()
 }
 
 
+void ACharacterCameraLogic::ApplyCameraOrientation()
+{
+	FCameraArmConfiguration Configuration;
+	ECameraRotationMode RotationMode;
+	if (!FindCameraArmConfiguration(CameraStyle, CameraOrientation, Configuration, RotationMode)) return;
+
+	BlendToArmConfiguration(Configuration);
+}
+
+
 void ACharacterCameraLogic::SetRotationToMovement()
 {
 	if (!GetCharacterMovement()) return;
@@ -202,10 +395,12 @@ void ACharacterCameraLogic::SetRotationToCamera()
 
 void ACharacterCameraLogic::UpdateCameraArmSettings(const FVector CameraLocation, const float SpringArmLength, const bool bEnableCameraLag, const float LagSpeed)
 {
-	CameraArm->TargetArmLength = SpringArmLength; // 340.0;
-	CameraArm->bEnableCameraLag = bEnableCameraLag; // true;
-	CameraArm->CameraLagSpeed = LagSpeed; // 2.3;
-	TargetOffset = CameraLocation;
+	FCameraArmConfiguration Configuration;
+	Configuration.Offset = CameraLocation;
+	Configuration.ArmLength = SpringArmLength;
+	Configuration.bEnableCameraLag = bEnableCameraLag;
+	Configuration.LagSpeed = LagSpeed;
+	BlendToArmConfiguration(Configuration);
 }
 
 
@@ -216,6 +411,241 @@ void ACharacterCameraLogic::UpdateCameraSocketLocation(const FVector Offset, con
 	CameraArm->SocketOffset = UKismetMathLibrary::VInterpTo(CameraArm->SocketOffset, SocketOffset, DeltaTime, CameraOrientationTransitionSpeed);
 	CameraArm->TargetOffset = UKismetMathLibrary::VInterpTo(CameraArm->TargetOffset, TargetOffset_Z, DeltaTime, CameraOrientationTransitionSpeed);
 }
+
+
+void ACharacterCameraLogic::BuildCameraArmTable()
+{
+	CameraStyleIds.Reset();
+	CameraArmTable.Reset();
+	CameraStyleRotationModes.Reset();
+
+	// The third person styles use the shoulder offsets, and orientations without an offset use the right shoulder
+	FCameraStyleConfiguration ThirdPerson;
+	ThirdPerson.RotationMode = ECameraRotationMode::ToMovement;
+	ThirdPerson.Default.Offset = CameraOffset_Right;
+	ThirdPerson.Default.ArmLength = TargetArmLength;
+	ThirdPerson.Default.bEnableCameraLag = true;
+	ThirdPerson.Default.LagSpeed = CameraLag;
+	ThirdPerson.Orientations.Add(ECameraOrientation::Center, ThirdPerson.Default).Offset = CameraOffset_Center;
+	ThirdPerson.Orientations.Add(ECameraOrientation::LeftShoulder, ThirdPerson.Default).Offset = CameraOffset_Left;
+
+	FCameraStyleConfiguration FirstPerson;
+	FirstPerson.RotationMode = ECameraRotationMode::ToCamera;
+	FirstPerson.Default.Offset = CameraOffset_FirstPerson;
+
+	FCameraStyleConfiguration Aiming = ThirdPerson;
+	Aiming.RotationMode = ECameraRotationMode::ToCamera;
+
+	// The spectator and fixed cameras aren't attached to the arm, so they keep the character's rotation and use the third person arm
+	FCameraStyleConfiguration Detached = ThirdPerson;
+	Detached.RotationMode = ECameraRotationMode::Unchanged;
+
+	AddCameraStyleToArmTable(CameraStyle_ThirdPerson, ThirdPerson);
+	AddCameraStyleToArmTable(CameraStyle_TargetLocking, ThirdPerson);
+	AddCameraStyleToArmTable(CameraStyle_FirstPerson, FirstPerson);
+	AddCameraStyleToArmTable(CameraStyle_Aiming, Aiming);
+	AddCameraStyleToArmTable(CameraStyle_Spectator, Detached);
+	AddCameraStyleToArmTable(CameraStyle_Fixed, Detached);
+
+	// The rail camera isn't attached to the arm either, and the character turns towards where it's moving since the camera isn't behind it
+	FCameraStyleConfiguration Rail = Detached;
+	Rail.RotationMode = ECameraRotationMode::ToMovement;
+	AddCameraStyleToArmTable(CameraStyle_Rail, Rail);
+
+	// Group framing places the camera from the group's bounds, so it's detached the same way
+	AddCameraStyleToArmTable(CameraStyle_GroupFraming, Rail);
+
+	for (const TPair<FName, FCameraStyleConfiguration>& CustomStyle : CustomCameraStyles)
+	{
+		AddCameraStyleToArmTable(CustomStyle.Key, CustomStyle.Value);
+	}
+}
+
+
+void ACharacterCameraLogic::AddCameraStyleToArmTable(const FName Style, const FCameraStyleConfiguration& Configuration)
+{
+	int32 StyleId;
+	if (const int32* ExistingId = CameraStyleIds.Find(Style))
+	{
+		StyleId = *ExistingId;
+	}
+	else
+	{
+		StyleId = CameraStyleRotationModes.AddDefaulted();
+		CameraArmTable.AddDefaulted(NumCameraOrientations);
+		CameraStyleIds.Add(Style, StyleId);
+	}
+
+	CameraStyleRotationModes[StyleId] = Configuration.RotationMode;
+	for (int32 Orientation = 0; Orientation < NumCameraOrientations; ++Orientation)
+	{
+		const FCameraArmConfiguration* OrientationConfiguration = Configuration.Orientations.Find(static_cast<ECameraOrientation>(Orientation));
+		CameraArmTable[GetCameraArmTableIndex(StyleId, static_cast<ECameraOrientation>(Orientation))] = OrientationConfiguration ? *OrientationConfiguration : Configuration.Default;
+	}
+}
+
+
+bool ACharacterCameraLogic::FindCameraArmConfiguration(const FName Style, const ECameraOrientation Orientation, FCameraArmConfiguration& OutConfiguration, ECameraRotationMode& OutRotationMode) const
+{
+	const int32* StyleId = CameraStyleIds.Find(Style);
+	if (!StyleId) return false;
+
+	const int32 Index = GetCameraArmTableIndex(*StyleId, Orientation);
+	if (!CameraArmTable.IsValidIndex(Index)) return false;
+
+	OutConfiguration = CameraArmTable[Index];
+	OutRotationMode = CameraStyleRotationModes[*StyleId];
+	return true;
+}
+
+
+int32 ACharacterCameraLogic::GetCameraArmTableIndex(const int32 StyleId, const ECameraOrientation Orientation)
+{
+	return StyleId * NumCameraOrientations + static_cast<int32>(Orientation);
+}
+
+
+void ACharacterCameraLogic::BlendToArmConfiguration(const FCameraArmConfiguration& Configuration)
+{
+	// Blend from wherever the arm currently is, so interrupted transitions don't snap
+	CameraArmBlend.Source = GetCurrentArmConfiguration();
+	CameraArmBlend.Target = Configuration;
+	CameraArmBlend.Speed = CameraOrientationTransitionSpeed;
+	CameraArmBlend.Alpha = 0.0f;
+	TargetOffset = Configuration.Offset;
+}
+
+
+void ACharacterCameraLogic::UpdateCameraArmBlend(const float DeltaTime)
+{
+	CameraArmBlend.Advance(DeltaTime);
+	ApplyCameraArmConfiguration(CameraArmBlend.Evaluate());
+}
+
+
+void ACharacterCameraLogic::ApplyCameraArmConfiguration(const FCameraArmConfiguration& Configuration)
+{
+	CameraArm->SocketOffset = FVector(Configuration.Offset.X, Configuration.Offset.Y, 0);
+	CameraArm->TargetOffset = FVector(0, 0, Configuration.Offset.Z);
+	CameraArm->TargetArmLength = Configuration.ArmLength;
+	CameraArm->bEnableCameraLag = Configuration.bEnableCameraLag;
+	CameraArm->CameraLagSpeed = Configuration.LagSpeed;
+}
+
+
+FCameraArmConfiguration ACharacterCameraLogic::GetCurrentArmConfiguration() const
+{
+	FCameraArmConfiguration Configuration;
+	Configuration.Offset = FVector(CameraArm->SocketOffset.X, CameraArm->SocketOffset.Y, CameraArm->TargetOffset.Z);
+	Configuration.ArmLength = CameraArm->TargetArmLength;
+	Configuration.bEnableCameraLag = CameraArm->bEnableCameraLag;
+	Configuration.LagSpeed = CameraArm->CameraLagSpeed;
+	return Configuration;
+}
+
+
+
+void ACharacterCameraLogic::RefreshNearCameraPrimitives()
+{
+	// The tracked meshes are hidden by the fade, not by their own settings, so they're shown again before checking which meshes the owner sees
+	if (bNearCameraHidden)
+	{
+		for (const TWeakObjectPtr<UMeshComponent>& Mesh : NearCameraPrimitives)
+		{
+			if (Mesh.IsValid()) Mesh->SetOwnerNoSee(false);
+		}
+	}
+
+	NearCameraPrimitives.Reset();
+	if (!bUseNearCameraFade)
+	{
+		NearCameraFade = 1.0f;
+		bNearCameraHidden = false;
+		return;
+	}
+
+	// Meshes that are already hidden from the owner stay that way
+	TInlineComponentArray<UMeshComponent*> Meshes(this);
+	for (UMeshComponent* Mesh : Meshes)
+	{
+		if (Mesh->bOwnerNoSee) continue;
+		NearCameraPrimitives.Add(Mesh);
+		Mesh->SetCustomPrimitiveDataFloat(NearCameraFadeDataIndex, NearCameraFade);
+		if (bNearCameraHidden) Mesh->SetOwnerNoSee(true);
+	}
+}
+
+
+FCameraRigSnapshot ACharacterCameraLogic::CaptureCameraRigSnapshot() const
+{
+	FCameraRigSnapshot Snapshot;
+	CameraArm->CaptureRigSnapshot(Snapshot);
+	Snapshot.ArmConfiguration = GetCurrentArmConfiguration();
+	Snapshot.CameraStyle = CameraStyle;
+	Snapshot.CameraOrientation = CameraOrientation;
+	Snapshot.bValid = true;
+	return Snapshot;
+}
+
+
+void ACharacterCameraLogic::RestoreCameraRigSnapshot(const FCameraRigSnapshot& Snapshot)
+{
+	if (!Snapshot.bValid) return;
+
+	// Start from the snapshot's arm settings, so the style's configuration is blended to from where the camera was
+	ApplyCameraArmConfiguration(Snapshot.ArmConfiguration);
+	CameraArmBlend.Alpha = 1.0f;
+	CameraArm->RestoreRigSnapshot(Snapshot);
+
+	// The transient styles would be stuck without a target or the aim input, so the new character starts in it's default style instead
+	const bool bTransientStyle = Snapshot.CameraStyle == CameraStyle_TargetLocking || Snapshot.CameraStyle == CameraStyle_Aiming;
+	const FName Style = bTransientStyle ? GetClass()->GetDefaultObject<ACharacterCameraLogic>()->CameraStyle : Snapshot.CameraStyle;
+	if (CameraStyle != Style)
+	{
+		Execute_SetCameraStyle(this, Style);
+	}
+
+	CameraOrientation = Snapshot.CameraOrientation;
+	OnCameraStyleSet();
+	OnCameraOrientationSet();
+}
+
+
+void ACharacterCameraLogic::UpdateNearCameraFade()
+{
+	// The camera isn't on the arm in the detached styles, and other players' views of the character are never faded
+	const bool bDetached = CameraStyle == CameraStyle_Spectator || CameraStyle == CameraStyle_Fixed || CameraStyle == CameraStyle_Rail || CameraStyle == CameraStyle_GroupFraming;
+	if (!bUseNearCameraFade || bDetached || !IsLocallyControlled())
+	{
+		ApplyNearCameraFade(1.0f, false);
+		return;
+	}
+
+	const float ArmLength = CameraArm->GetCollisionAdjustedArmLength();
+	const bool bHidden = bNearCameraHidden ? ArmLength < NearCameraHideDistance + NearCameraHysteresis : ArmLength < NearCameraHideDistance;
+	const float FadeRange = FMath::Max(NearCameraFadeDistance - NearCameraHideDistance, UE_KINDA_SMALL_NUMBER);
+	const float Fade = bHidden ? 0.0f : FMath::Clamp((ArmLength - NearCameraHideDistance) / FadeRange, 0.0f, 1.0f);
+	ApplyNearCameraFade(Fade, bHidden);
+}
+
+
+void ACharacterCameraLogic::ApplyNearCameraFade(float Fade, const bool bHidden)
+{
+	// Rounding the fade keeps a slowly moving arm from dirtying the meshes' render state every frame
+	Fade = FMath::RoundToFloat(Fade * 32.0f) / 32.0f;
+	const bool bFadeChanged = Fade != NearCameraFade;
+	const bool bHiddenChanged = bHidden != bNearCameraHidden;
+	if (!bFadeChanged && !bHiddenChanged) return;
+
+	NearCameraFade = Fade;
+	bNearCameraHidden = bHidden;
+	for (const TWeakObjectPtr<UMeshComponent>& Mesh : NearCameraPrimitives)
+	{
+		if (!Mesh.IsValid()) continue;
+		if (bFadeChanged) Mesh->SetCustomPrimitiveDataFloat(NearCameraFadeDataIndex, Fade);
+		if (bHiddenChanged) Mesh->SetOwnerNoSee(bHidden);
+	}
+}
 #pragma endregion
 
 
@@ -224,75 +654,112 @@ void ACharacterCameraLogic::UpdateCameraSocketLocation(const FVector Offset, con
 #pragma region Target Locking
 void ACharacterCameraLogic::AdjustCurrentTarget_Implementation(TArray<AActor*>& ActorsToIgnore, EPreviousTargetLockOrientation NextTargetDirection, float Radius)
 {
-	if (TargetLockCharacters.Num() == 0)
+	TArray<FVector, TInlineAllocator<16>> TargetLocations;
+	if (TargetLockCharacters.Num() > 1)
+	{
+		for (const AActor* Target : TargetLockCharacters) TargetLocations.Add(Target->GetActorLocation());
+	}
+
+	FTargetLockInformation NextTarget;
+	const ETargetSelectionResult Result = SelectNextTarget(
+		GetActorLocation(),
+		GetBaseAimRotation(),
+		this,
+		CurrentTarget,
+		TargetLockCharacters,
+		TargetLocations,
+		NextTargetDirection,
+		TargetLockData,
+		NextTarget
+	);
+
+	if (Result == ETargetSelectionResult::NoTargets)
 	{
 		if (bDebugTargetLocking)
 		{
 			UE_LOGFMT(CameraLog, Error, "{0}: There are no more characters within {1}'s target lock range!", *UEnum::GetValueAsString(GetLocalRole()), *GetName());
 		}
-		
-		bCurrentTargetDelay = false;
-		SetCurrentTarget(nullptr);
-		TrySetServerCurrentTarget();
-		if (CameraStyle == CameraStyle_TargetLocking)
-		{
-			Execute_SetCameraStyle(this, CameraStyle_ThirdPerson);
-			OnCameraStyleSet();
-		}
-		return;	
+
+		BreakTargetLock();
+		return;
 	}
-	
-	if (TargetLockCharacters.Num() == 1)
+
+	if (Result == ETargetSelectionResult::Unchanged)
 	{
-		if (TargetLockCharacters[0] == this) return;
-		SetCurrentTarget(TargetLockCharacters[0]);
-		TrySetServerCurrentTarget();
 		return;
 	}
-	
-	const FVector PlayerLocation = GetActorLocation();
-	const FRotator BaseAimRotation = GetBaseAimRotation();
+
+	if (bDebugTargetLocking)
+	{
+		UE_LOGFMT(CameraLog, Log, "{0}: NextTarget: {1}, YawOffset: {2}", *UEnum::GetValueAsString(GetLocalRole()), *GetNameSafe(NextTarget.Target), NextTarget.AngleFromForwardVector);
+	}
+
+	ApplyTargetSelection(NextTarget.Target);
+}
+
+
+ETargetSelectionResult ACharacterCameraLogic::SelectNextTarget(
+	const FVector& PlayerLocation,
+	const FRotator& BaseAimRotation,
+	const AActor* Self,
+	const AActor* PreviousTarget,
+	TArrayView<AActor* const> Targets,
+	TArrayView<const FVector> TargetLocations,
+	const EPreviousTargetLockOrientation NextTargetDirection,
+	TArray<FTargetLockInformation>& OutTargetLockData,
+	FTargetLockInformation& OutNextTarget)
+{
+	if (Targets.Num() == 0)
+	{
+		return ETargetSelectionResult::NoTargets;
+	}
+
+	if (Targets.Num() == 1)
+	{
+		if (Targets[0] == Self) return ETargetSelectionResult::Unchanged;
+		OutNextTarget = FTargetLockInformation(Targets[0]);
+		return ETargetSelectionResult::Selected;
+	}
+
 	const FRotator PlayerRotation = FRotator(0.0f, BaseAimRotation.Yaw, BaseAimRotation.Roll);
 
 	// TODO: Update this to also account for how close the players are to the character
 	// Calculate the distance from the character and the angle from it's forward vector
-	TargetLockData.Empty();
-	for (AActor* Target : TargetLockCharacters)
+	OutTargetLockData.Reset();
+	for (int32 Index = 0; Index < Targets.Num(); ++Index)
 	{
-		if (Target == this) continue;
-		
+		AActor* Target = Targets[Index];
+		if (Target == Self) continue;
+
 		FTargetLockInformation TargetLockInfo;
 		TargetLockInfo.Target = Target;
 
-		FVector PlayerToTarget = TargetLockInfo.Target->GetActorLocation() - PlayerLocation;
-		TargetLockInfo.DistanceToTarget = PlayerToTarget.Length(); 
+		const FVector PlayerToTarget = TargetLocations[Index] - PlayerLocation;
+		TargetLockInfo.DistanceToTarget = PlayerToTarget.Length();
 
 		const FRotator PlayerToTargetRotation = PlayerToTarget.Rotation();
 		const FRotator DeltaRotation = UKismetMathLibrary::NormalizedDeltaRotator(PlayerToTargetRotation, PlayerRotation);
 		TargetLockInfo.AngleFromForwardVector = DeltaRotation.Yaw; // Negative is to the right, positive is to the left
-		TargetLockData.Add(TargetLockInfo);
-		
-		// if (bDebugTargetLocking)
-		// {
-		// 	UE_LOGFMT(CameraLog, Log, "{0}: target {1}, RotationFromCharacter: {2}, DistanceToTarget: {3}",
-		// 		*UEnum::GetValueAsString(GetLocalRole()), *GetNameSafe(TargetLockInfo.Target), TargetLockInfo.AngleFromForwardVector, TargetLockInfo.DistanceToTarget
-		// 	);
-		// }
+		OutTargetLockData.Add(TargetLockInfo);
 	}
-	
+
+	if (OutTargetLockData.IsEmpty())
+	{
+		return ETargetSelectionResult::Unchanged;
+	}
+
 	// Adjust the array of the characters from left to right (180, -180)
-	TargetLockData.Sort([](const FTargetLockInformation& PreviousTargetData, const FTargetLockInformation& CurrentTargetData) {
+	OutTargetLockData.Sort([](const FTargetLockInformation& PreviousTargetData, const FTargetLockInformation& CurrentTargetData) {
 		return PreviousTargetData.AngleFromForwardVector > CurrentTargetData.AngleFromForwardVector;
 	});
-	// for (auto Target: TargetLockData) if (bDebugTargetLocking) UE_LOGFMT(CameraLog, Log, "Adjusted Target List: {0}, YawOffset: {1}", *GetNameSafe(Target.Target), Target.AngleFromForwardVector);
-	
+
 	int32 CurrentTargetIndex = 0;
 	float ClosestToCharacterYaw = 340.0f;
-	for (int32 Index = 0; Index != TargetLockData.Num(); ++Index)
+	for (int32 Index = 0; Index != OutTargetLockData.Num(); ++Index)
 	{
-		if (CurrentTarget)
+		if (PreviousTarget)
 		{
-			if (TargetLockData[Index].Target == CurrentTarget)
+			if (OutTargetLockData[Index].Target == PreviousTarget)
 			{
 				CurrentTargetIndex = Index;
 				break;
@@ -301,7 +768,7 @@ void ACharacterCameraLogic::AdjustCurrentTarget_Implementation(TArray<AActor*>&
 		else
 		{
 			// Find the target closest to where the character is looking
-			const float TargetToCharacterYaw = TargetLockData[Index].AngleFromForwardVector < 0.0f ? -1 * TargetLockData[Index].AngleFromForwardVector : TargetLockData[Index].AngleFromForwardVector;
+			const float TargetToCharacterYaw = OutTargetLockData[Index].AngleFromForwardVector < 0.0f ? -1 * OutTargetLockData[Index].AngleFromForwardVector : OutTargetLockData[Index].AngleFromForwardVector;
 			if (TargetToCharacterYaw < ClosestToCharacterYaw)
 			{
 				CurrentTargetIndex = Index;
@@ -309,35 +776,50 @@ void ACharacterCameraLogic::AdjustCurrentTarget_Implementation(TArray<AActor*>&
 			}
 		}
 	}
-	
+
 	// This is for navigating between the previous or next target
-	FTargetLockInformation NextTarget = TargetLockData[CurrentTargetIndex];
-	if (CurrentTarget)
+	OutNextTarget = OutTargetLockData[CurrentTargetIndex];
+	if (PreviousTarget)
 	{
 		if (NextTargetDirection == EPreviousTargetLockOrientation::Right)
 		{
-			if (TargetLockData.IsValidIndex(CurrentTargetIndex - 1)) NextTarget = TargetLockData[CurrentTargetIndex - 1];
-			else NextTarget = TargetLockData.Last();
+			if (OutTargetLockData.IsValidIndex(CurrentTargetIndex - 1)) OutNextTarget = OutTargetLockData[CurrentTargetIndex - 1];
+			else OutNextTarget = OutTargetLockData.Last();
 		}
 		else
 		{
-			if (TargetLockData.IsValidIndex(CurrentTargetIndex + 1)) NextTarget = TargetLockData[CurrentTargetIndex + 1];
-			else NextTarget = TargetLockData[0];
+			if (OutTargetLockData.IsValidIndex(CurrentTargetIndex + 1)) OutNextTarget = OutTargetLockData[CurrentTargetIndex + 1];
+			else OutNextTarget = OutTargetLockData[0];
 		}
 	}
 
-	if (bDebugTargetLocking)
+	return ETargetSelectionResult::Selected;
+}
+
+
+void ACharacterCameraLogic::ApplyTargetSelection(AActor* NextTarget)
+{
+	SetCurrentTarget(NextTarget);
+	TrySetServerCurrentTarget();
+}
+
+
+void ACharacterCameraLogic::BreakTargetLock()
+{
+	bCurrentTargetDelay = false;
+	SetCurrentTarget(nullptr);
+	TrySetServerCurrentTarget();
+	if (CameraStyle == CameraStyle_TargetLocking)
 	{
-		UE_LOGFMT(CameraLog, Log, "{0}: NextTarget: {1}, YawOffset: {2}", *UEnum::GetValueAsString(GetLocalRole()), *GetNameSafe(NextTarget.Target), NextTarget.AngleFromForwardVector);
+		Execute_SetCameraStyle(this, CameraStyle_ThirdPerson);
+		OnCameraStyleSet();
 	}
-	
-	SetCurrentTarget(NextTarget.Target);
-	TrySetServerCurrentTarget();
 }
 
 
 void ACharacterCameraLogic::Server_SetTargetLockData_Implementation(AActor* Target)
 {
+	CAMERA_NET_RECORD(this, GET_FUNCTION_NAME_CHECKED(ACharacterCameraLogic, Server_SetTargetLockData), ECameraNetEvent::Received, FCameraNetProfiler::RpcHeaderSize + FCameraNetProfiler::EstimateObjectSize(Target));
 	SetCurrentTarget(Target);
 	OnTargetLockCharacterUpdated();
 }
@@ -345,26 +827,41 @@ void ACharacterCameraLogic::Server_SetTargetLockData_Implementation(AActor* Targ
 
 void ACharacterCameraLogic::OnTargetLockCharacterUpdated()
 {
-	if (CameraStyle != CameraStyle_TargetLocking)
+	if (bCoalesceCameraEvents)
 	{
-		SetCurrentTarget(nullptr);
+		MarkCameraEventsDirty(ECameraEventFlags::Target);
+		return;
 	}
 
-	CameraArm->UpdateTargetLockOffset(FVector(0, 0, 25));
+	ApplyTargetLockCharacter();
 	
 	// blueprint logic
 	BP_OnTargetLockCharacterUpdated();
 }
 
 
+void ACharacterCameraLogic::ApplyTargetLockCharacter()
+{
+	if (CameraStyle != CameraStyle_TargetLocking)
+	{
+		SetCurrentTarget(nullptr);
+	}
+
+	CameraArm->UpdateTargetLockOffset(FVector(0, 0, 25));
+	UpdateTargetReevaluation();
+}
+
+
 void ACharacterCameraLogic::ResetCurrentTargetDelay() { bCurrentTargetDelay = false; }
 void ACharacterCameraLogic::TrySetServerCurrentTarget()
 {
 	if (bCurrentTargetDelay)
 	{
+		CAMERA_NET_RECORD(this, GET_FUNCTION_NAME_CHECKED(ACharacterCameraLogic, Server_SetTargetLockData), ECameraNetEvent::Throttled, 0);
 		return;
 	}
 	
+	CAMERA_NET_RECORD(this, GET_FUNCTION_NAME_CHECKED(ACharacterCameraLogic, Server_SetTargetLockData), FCameraNetProfiler::GetUnreliableSendEvent(this), FCameraNetProfiler::RpcHeaderSize + FCameraNetProfiler::EstimateObjectSize(GetCurrentTarget()));
 	Server_SetTargetLockData(GetCurrentTarget());
 	GetWorldTimerManager().SetTimer(
 		CurrentTargetDelayHandle,
@@ -378,6 +875,47 @@ void ACharacterCameraLogic::TrySetServerCurrentTarget()
 }
 
 
+float ACharacterCameraLogic::ScoreTarget(const AActor* Target) const
+{
+	if (Target == this || !IsTargetValid(Target)) return MAX_FLT;
+
+	const FVector PlayerToTarget = Target->GetActorLocation() - GetActorLocation();
+	const float DistanceToTarget = PlayerToTarget.Length();
+	if (TargetLockBreakDistance > 0.0f && DistanceToTarget > TargetLockBreakDistance) return MAX_FLT;
+
+	const FRotator BaseAimRotation = GetBaseAimRotation();
+	const FRotator PlayerRotation = FRotator(0.0f, BaseAimRotation.Yaw, BaseAimRotation.Roll);
+	const FRotator DeltaRotation = UKismetMathLibrary::NormalizedDeltaRotator(PlayerToTarget.Rotation(), PlayerRotation);
+
+	const float AngleScore = FMath::Abs(DeltaRotation.Yaw) / 180.0f;
+	const float DistanceScore = TargetLockBreakDistance > 0.0f ? DistanceToTarget / TargetLockBreakDistance : 0.0f;
+	return AngleScore * TargetAngleScoreWeight + DistanceScore * TargetDistanceScoreWeight;
+}
+
+
+bool ACharacterCameraLogic::IsTargetValid_Implementation(const AActor* Target) const
+{
+	return IsValid(Target) && !Target->IsActorBeingDestroyed() && !Target->IsHidden();
+}
+
+
+void ACharacterCameraLogic::UpdateTargetReevaluation()
+{
+	UCameraTargetingSubsystem* TargetingSubsystem = GetWorld() ? GetWorld()->GetSubsystem<UCameraTargetingSubsystem>() : nullptr;
+	if (!TargetingSubsystem) return;
+
+	// Targets are selected by whoever controls the character, which is the owning client for players and the server for ai
+	if (bReevaluateTargets && IsTargetLocking() && IsLocallyControlled())
+	{
+		TargetingSubsystem->RegisterTargetReevaluation(this);
+	}
+	else
+	{
+		TargetingSubsystem->UnregisterTargetReevaluation(this);
+	}
+}
+
+
 void ACharacterCameraLogic::ClearTargetLockCharacters(TArray<AActor*>& ActorsToIgnore)
 {
 	if (ActorsToIgnore.IsEmpty()) TargetLockCharacters.Empty();
@@ -412,6 +950,360 @@ void ACharacterCameraLogic::ClearTargetLockCharacters(TArray<AActor*>& ActorsToI
 
 
 
+#pragma region Camera Events
+void ACharacterCameraLogic::MarkCameraEventsDirty(const ECameraEventFlags Events)
+{
+	PendingCameraEvents |= Events;
+
+	// The character's tick may have already flushed this frame
+	if (!PostActorTickFlushHandle.IsValid() && HasActorBegunPlay())
+	{
+		PostActorTickFlushHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &ACharacterCameraLogic::OnWorldPostActorTick);
+	}
+}
+
+
+void ACharacterCameraLogic::OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaTime)
+{
+	if (World != GetWorld()) return;
+	FlushCameraEvents();
+}
+
+
+void ACharacterCameraLogic::FlushCameraEvents()
+{
+	if (PostActorTickFlushHandle.IsValid())
+	{
+		FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickFlushHandle);
+		PostActorTickFlushHandle.Reset();
+	}
+	if (PendingCameraEvents == ECameraEventFlags::None) return;
+
+	// Clear the pending events first, anything that's updated during the events is sent during the next flush
+	const ECameraEventFlags Events = PendingCameraEvents;
+	PendingCameraEvents = ECameraEventFlags::None;
+
+	// Apply the updates in the same order as the individual events
+	const bool bStyleUpdated = EnumHasAnyFlags(Events, ECameraEventFlags::Style);
+	const bool bOrientationUpdated = EnumHasAnyFlags(Events, ECameraEventFlags::Orientation);
+	const bool bTargetUpdated = EnumHasAnyFlags(Events, ECameraEventFlags::Target);
+	if (bStyleUpdated) ApplyCameraStyle();
+	if (bOrientationUpdated) ApplyCameraOrientation();
+	if (bTargetUpdated) ApplyTargetLockCharacter();
+
+	FCameraStateChange Change;
+	Change.OldStyle = FlushedCameraStyle;
+	Change.NewStyle = CameraStyle;
+	Change.OldOrientation = FlushedCameraOrientation;
+	Change.NewOrientation = CameraOrientation;
+	Change.OldTarget = FlushedCurrentTarget;
+	Change.NewTarget = CurrentTarget;
+	Change.bStyleUpdated = bStyleUpdated;
+	Change.bOrientationUpdated = bOrientationUpdated;
+	Change.bTargetUpdated = bTargetUpdated;
+
+	FlushedCameraStyle = CameraStyle;
+	FlushedCameraOrientation = CameraOrientation;
+	FlushedCurrentTarget = CurrentTarget;
+
+	if (bDebugCameraStyle && bStyleUpdated)
+	{
+		UE_LOGFMT(CameraLog, Log, "{0}: {1}'s camera style was updated from {2} to {3}",
+			*UEnum::GetValueAsString(GetLocalRole()), *GetName(), Change.OldStyle, Change.NewStyle
+		);
+	}
+
+	if (bDebugCameraOrientation && bOrientationUpdated)
+	{
+		UE_LOGFMT(CameraLog, Log, "{0}: {1}'s camera orientation was updated from {2} to {3}",
+			*UEnum::GetValueAsString(GetLocalRole()), *GetName(), *UEnum::GetValueAsString(Change.OldOrientation), *UEnum::GetValueAsString(Change.NewOrientation)
+		);
+	}
+
+	// The individual blueprint events are still sent, once each
+	if (bStyleUpdated) BP_OnCameraStyleSet();
+	if (bOrientationUpdated) BP_OnCameraOrientationSet();
+	if (bTargetUpdated) BP_OnTargetLockCharacterUpdated();
+
+	BP_OnCameraStateChanged(Change);
+	OnCameraStateChanged.Broadcast(Change);
+}
+#pragma endregion
+
+
+
+
+#pragma region Networking
+float ACharacterCameraLogic::GetNetPriority(const FVector& ViewPos, const FVector& ViewDir, AActor* Viewer, AActor* ViewTarget, UActorChannel* InChannel, float Time, bool bLowBandwidth)
+{
+	const float Priority = Super::GetNetPriority(ViewPos, ViewDir, Viewer, ViewTarget, InChannel, Time, bLowBandwidth);
+	return ABasePlayerCameraManager::ScaleNetPriorityForViewer(this, Viewer, Priority);
+}
+
+
+bool ACharacterCameraLogic::IsNetRelevantFor(const AActor* RealViewer, const AActor* ViewTarget, const FVector& SrcLocation) const
+{
+	if (!Super::IsNetRelevantFor(RealViewer, ViewTarget, SrcLocation)) return false;
+
+	// Always relevant to the owner and the character's view target
+	if (RealViewer == GetController() || ViewTarget == this) return true;
+	const ABasePlayerCameraManager* CameraManager = ABasePlayerCameraManager::GetNetPriorityCameraManager(RealViewer);
+	return !CameraManager || CameraManager->IsNetRelevantToCamera(this);
+}
+
+
+void ACharacterCameraLogic::TryReportCameraFOV()
+{
+	if (HasAuthority() || !IsLocallyControlled()) return;
+
+	const APlayerController* PlayerController = Cast<APlayerController>(GetController());
+	const ABasePlayerCameraManager* CameraManager = PlayerController ? Cast<ABasePlayerCameraManager>(PlayerController->PlayerCameraManager) : nullptr;
+	if (!CameraManager || !CameraManager->bUseCameraNetPriority) return;
+
+	const uint8 FOV = static_cast<uint8>(FMath::Clamp(FMath::RoundToInt(CameraManager->GetFOVAngle()), 1, 179));
+	if (FOV != ReportedCameraFOV)
+	{
+		ReportedCameraFOV = FOV;
+		CAMERA_NET_RECORD(this, GET_FUNCTION_NAME_CHECKED(ACharacterCameraLogic, Server_ReportCameraFOV), ECameraNetEvent::Sent, FCameraNetProfiler::RpcHeaderSize + sizeof(uint8));
+		Server_ReportCameraFOV(FOV);
+	}
+}
+
+
+void ACharacterCameraLogic::Server_ReportCameraFOV_Implementation(const uint8 FOV)
+{
+	CAMERA_NET_RECORD(this, GET_FUNCTION_NAME_CHECKED(ACharacterCameraLogic, Server_ReportCameraFOV), ECameraNetEvent::Received, FCameraNetProfiler::RpcHeaderSize + sizeof(uint8));
+	const APlayerController* PlayerController = Cast<APlayerController>(GetController());
+	ABasePlayerCameraManager* CameraManager = PlayerController ? Cast<ABasePlayerCameraManager>(PlayerController->PlayerCameraManager) : nullptr;
+	if (CameraManager)
+	{
+		CameraManager->SetReportedViewFOV(FOV);
+	}
+}
+
+
+
+bool ACharacterCameraLogic::GetSpectatorView(FVector& OutLocation, FRotator& OutRotation, float& OutFOV) const
+{
+	if (!bReplicateSpectatorView || IsLocallyControlled()) return false;
+
+	// Hold the last view once the owner stops sending it, instead of snapping back to the simulated camera between updates
+	const double Time = GetWorld()->GetTimeSeconds() - SpectatorViewInterpolationDelay;
+	return SpectatorViewBuffer.Evaluate(Time, GetActorLocation(), OutLocation, OutRotation, OutFOV);
+}
+
+
+bool ACharacterCameraLogic::IsBeingSpectated() const
+{
+	return bIsBeingSpectated;
+}
+
+
+void ACharacterCameraLogic::ResetSpectatorView()
+{
+	SpectatorViewBuffer.Reset();
+}
+
+
+void ACharacterCameraLogic::TryReportSpectatorView()
+{
+	if (!bReplicateSpectatorView || !bIsBeingSpectated || !IsLocallyControlled()) return;
+
+	const double Time = GetWorld()->GetTimeSeconds();
+	if (Time < NextSpectatorViewTime) return;
+	NextSpectatorViewTime = Time + 1.0 / FMath::Max(SpectatorViewRate, 1.0f);
+
+	// The camera manager's cached view is the final view of the last frame, after the modifiers and collision
+	const APlayerController* PlayerController = Cast<APlayerController>(GetController());
+	const APlayerCameraManager* CameraManager = PlayerController ? PlayerController->PlayerCameraManager.Get() : nullptr;
+	if (!CameraManager) return;
+
+	const FMinimalViewInfo& View = CameraManager->GetCameraCacheView();
+	const FSpectatorViewSample Sample = FSpectatorViewSample::Quantize(View.Location, View.Rotation, View.FOV, GetActorLocation());
+	if (Sample == SentSpectatorView && Time < NextSpectatorKeyframeTime) return;
+	SentSpectatorView = Sample;
+	NextSpectatorKeyframeTime = Time + SpectatorViewKeyframeInterval;
+
+	// The listen server's own character doesn't need to send it
+	if (HasAuthority())
+	{
+		SpectatorView = Sample;
+		return;
+	}
+
+	CAMERA_NET_RECORD(this, GET_FUNCTION_NAME_CHECKED(ACharacterCameraLogic, Server_ReportSpectatorView), FCameraNetProfiler::GetUnreliableSendEvent(this), FCameraNetProfiler::RpcHeaderSize + FSpectatorViewSample::EstimatedNetSize);
+	Server_ReportSpectatorView(Sample);
+}
+
+
+void ACharacterCameraLogic::UpdateSpectatedState()
+{
+	if (!HasAuthority() || GetNetMode() == NM_Standalone) return;
+
+	const double Time = GetWorld()->GetTimeSeconds();
+	if (Time < NextSpectatorCheckTime) return;
+	NextSpectatorCheckTime = Time + CVarSpectatorCheckInterval.GetValueOnGameThread();
+
+	// Anyone in the spectating state or viewing something other than their own pawn is a spectator
+	bool bSpectated = false;
+	bHasSpectators = false;
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+		if (!PlayerController || PlayerController == GetController()) continue;
+
+		const AActor* ViewTarget = PlayerController->GetViewTarget();
+		bSpectated |= bReplicateSpectatorView && ViewTarget == this;
+		bHasSpectators |= PlayerController->IsInState(NAME_Spectating) || ViewTarget != PlayerController->GetPawn();
+	}
+
+	if (bSpectated != bIsBeingSpectated)
+	{
+		bIsBeingSpectated = bSpectated;
+		SentSpectatorView = FSpectatorViewSample();
+	}
+}
+
+
+void ACharacterCameraLogic::Server_ReportSpectatorView_Implementation(const FSpectatorViewSample& View)
+{
+	CAMERA_NET_RECORD(this, GET_FUNCTION_NAME_CHECKED(ACharacterCameraLogic, Server_ReportSpectatorView), ECameraNetEvent::Received, FCameraNetProfiler::RpcHeaderSize + FSpectatorViewSample::EstimatedNetSize);
+	if (!bIsBeingSpectated) return;
+	SpectatorView = View;
+
+	// The listen server's player doesn't receive the replicated view
+	if (GetNetMode() == NM_ListenServer)
+	{
+		SpectatorViewBuffer.Add(View, GetWorld()->GetTimeSeconds());
+	}
+}
+
+
+void ACharacterCameraLogic::OnRep_SpectatorView()
+{
+	CAMERA_NET_RECORD(this, GET_MEMBER_NAME_CHECKED(ACharacterCameraLogic, SpectatorView), ECameraNetEvent::Received, FSpectatorViewSample::EstimatedNetSize);
+	SpectatorViewBuffer.Add(SpectatorView, GetWorld()->GetTimeSeconds());
+}
+
+
+void ACharacterCameraLogic::OnRep_IsBeingSpectated()
+{
+	CAMERA_NET_RECORD(this, GET_MEMBER_NAME_CHECKED(ACharacterCameraLogic, bIsBeingSpectated), ECameraNetEvent::Received, sizeof(uint8));
+	SentSpectatorView = FSpectatorViewSample();
+	NextSpectatorViewTime = 0.0;
+	NextSpectatorKeyframeTime = 0.0;
+}
+
+
+
+const FCameraDirectorState& ACharacterCameraLogic::GetDirectorState() const
+{
+	return DirectorState;
+}
+
+
+void ACharacterCameraLogic::UpdateDirectorState()
+{
+	if (!HasAuthority() || GetNetMode() == NM_Standalone) return;
+
+	// Only assigned when something changed, so the state isn't dirtied every frame
+	const bool bTargetLocking = IsTargetLocking();
+	if (bTargetLocking != DirectorState.bTargetLocking) DirectorState.bTargetLocking = bTargetLocking;
+	if (CurrentTarget != DirectorState.Target)
+	{
+		DirectorState.Target = CurrentTarget;
+		if (CurrentTarget) ++DirectorState.TargetLocks;
+	}
+}
+
+
+void ACharacterCameraLogic::OnRep_DirectorState()
+{
+	CAMERA_NET_RECORD(this, GET_MEMBER_NAME_CHECKED(ACharacterCameraLogic, DirectorState), ECameraNetEvent::Received, FCameraDirectorState::EstimatedNetSize);
+}
+
+
+void ACharacterCameraLogic::OnDirectorStateDamaged(AActor* DamagedActor, const float Damage, const UDamageType* DamageType, AController* InstigatedBy, AActor* DamageCauser)
+{
+	if (Damage <= 0.0f) return;
+	DirectorState.DamageTaken += Damage;
+
+	ACharacterCameraLogic* Instigator = InstigatedBy ? Cast<ACharacterCameraLogic>(InstigatedBy->GetPawn()) : nullptr;
+	if (Instigator && Instigator != this)
+	{
+		Instigator->DirectorState.DamageDealt += Damage;
+	}
+}
+
+
+bool ACharacterCameraLogic::GetCameraViewAtTime(const double ServerTime, FVector& OutLocation, FRotator& OutRotation) const
+{
+	if (!bRecordCameraViewHistory || ServerTime < CameraViewHistory.GetOldestTime()) return false;
+	return CameraViewHistory.Evaluate(ServerTime, OutLocation, OutRotation);
+}
+
+
+const FCameraViewHistory& ACharacterCameraLogic::GetCameraViewHistory() const
+{
+	return CameraViewHistory;
+}
+
+
+void ACharacterCameraLogic::TryReportCameraViewHistory()
+{
+	if (!bRecordCameraViewHistory || !IsLocallyControlled() || GetNetMode() == NM_Standalone) return;
+
+	const double Time = GetWorld()->GetTimeSeconds();
+	if (Time < NextCameraViewHistoryTime) return;
+	NextCameraViewHistoryTime = Time + 1.0 / FMath::Max(CameraViewHistoryRate, 1.0f);
+
+	// Shots are stamped with the same estimate of the server's time, so the history lines up with them instead of with when the reports arrived
+	const AGameStateBase* GameState = GetWorld()->GetGameState();
+	const APlayerController* PlayerController = Cast<APlayerController>(GetController());
+	const APlayerCameraManager* CameraManager = PlayerController ? PlayerController->PlayerCameraManager.Get() : nullptr;
+	if (!GameState || !CameraManager) return;
+
+	const FMinimalViewInfo& View = CameraManager->GetCameraCacheView();
+	const FCameraViewReport Report = FCameraViewReport::Quantize(GameState->GetServerWorldTimeSeconds(), View.Location, View.Rotation);
+
+	// The listen server's own character records it directly
+	if (HasAuthority())
+	{
+		RecordCameraView(Report);
+		return;
+	}
+
+	CAMERA_NET_RECORD(this, GET_FUNCTION_NAME_CHECKED(ACharacterCameraLogic, Server_ReportCameraView), FCameraNetProfiler::GetUnreliableSendEvent(this), FCameraNetProfiler::RpcHeaderSize + FCameraViewReport::EstimatedNetSize);
+	Server_ReportCameraView(Report);
+}
+
+
+void ACharacterCameraLogic::Server_ReportCameraView_Implementation(const FCameraViewReport& View)
+{
+	CAMERA_NET_RECORD(this, GET_FUNCTION_NAME_CHECKED(ACharacterCameraLogic, Server_ReportCameraView), ECameraNetEvent::Received, FCameraNetProfiler::RpcHeaderSize + FCameraViewReport::EstimatedNetSize);
+	if (!bRecordCameraViewHistory) return;
+	RecordCameraView(View);
+}
+
+
+void ACharacterCameraLogic::RecordCameraView(const FCameraViewReport& View)
+{
+	// Clients aren't trusted with the time or the location, views from the future are clamped to the present and views away from the character are dropped
+	FCameraViewReport Report = View;
+	Report.ServerTime = FMath::Min(Report.ServerTime, GetWorld()->GetTimeSeconds());
+	if (CameraViewHistoryMaxDistance > 0.0f && FVector::DistSquared(Report.Location, GetActorLocation()) > FMath::Square(CameraViewHistoryMaxDistance))
+	{
+		UE_LOGFMT(CameraLog, Verbose, "{0} reported a camera view {1} away from it's character, ignoring it", *GetName(), FVector::Dist(Report.Location, GetActorLocation()));
+		return;
+	}
+
+	CameraViewHistory.Add(Report);
+}
+#pragma endregion
+
+
+
+
 #pragma region Utility
 FName ACharacterCameraLogic::GetCameraStyle_Implementation() const
 {
@@ -427,10 +1319,10 @@ ECameraOrientation ACharacterCameraLogic::GetCameraOrientation_Implementation()
 
 FVector ACharacterCameraLogic::GetCameraOffset(const FName Style, const ECameraOrientation Orientation) const
 {
-	if (Style == CameraStyle_FirstPerson) return CameraOffset_FirstPerson;
-	if (Orientation == ECameraOrientation::Center) return CameraOffset_Center;
-	if (Orientation == ECameraOrientation::LeftShoulder) return CameraOffset_Left;
-	return CameraOffset_Right;
+	FCameraArmConfiguration Configuration;
+	ECameraRotationMode RotationMode;
+	if (FindCameraArmConfiguration(Style, Orientation, Configuration, RotationMode)) return Configuration.Offset;
+	return Orientation == ECameraOrientation::Center ? CameraOffset_Center : Orientation == ECameraOrientation::LeftShoulder ? CameraOffset_Left : CameraOffset_Right;
 }
 
 
@@ -454,6 +1346,103 @@ float ACharacterCameraLogic::GetCameraArmLength() const
 }
 
 
+FVector ACharacterCameraLogic::GetTargetCameraOffset() const
+{
+	return TargetOffset;
+}
+
+
+float ACharacterCameraLogic::GetCameraOrientationTransitionSpeed() const
+{
+	return CameraOrientationTransitionSpeed;
+}
+
+
+void ACharacterCameraLogic::GetCameraMemoryBreakdown(FCameraMemoryBreakdown& OutBreakdown) const
+{
+	using FBreakdown = FCameraMemoryBreakdown;
+
+	// The camera's post process settings are the largest part of a camera character, the camera component has a third copy
+	SIZE_T PostProcessAllocated = HideCamera.WeightedBlendables.Array.GetAllocatedSize() + DefaultCameraSettings.WeightedBlendables.Array.GetAllocatedSize();
+	if (FollowCamera) PostProcessAllocated += FollowCamera->PostProcessSettings.WeightedBlendables.Array.GetAllocatedSize();
+	OutBreakdown.Add(FBreakdown::PostProcess, sizeof(HideCamera) + sizeof(DefaultCameraSettings), PostProcessAllocated);
+
+	SIZE_T ComponentsInline = 0;
+	SIZE_T ComponentsAllocated = 0;
+	if (CameraArm)
+	{
+		ComponentsInline += CameraArm->GetClass()->GetStructureSize();
+		ComponentsAllocated += CameraArm->GetAllocatedRigSize();
+	}
+	if (FollowCamera)
+	{
+		ComponentsInline += FollowCamera->GetClass()->GetStructureSize();
+	}
+	ComponentsAllocated += NearCameraPrimitives.GetAllocatedSize();
+	OutBreakdown.Add(FBreakdown::Components, ComponentsInline, ComponentsAllocated);
+
+	OutBreakdown.Add(FBreakdown::TargetLocking,
+		sizeof(TargetLockCharacters) + sizeof(TargetLockData) + sizeof(CurrentTargetDelayHandle) + sizeof(CameraTransitionDelayHandle),
+		TargetLockCharacters.GetAllocatedSize() + TargetLockData.GetAllocatedSize()
+	);
+
+	SIZE_T CustomStylesAllocated = CustomCameraStyles.GetAllocatedSize();
+	for (const TPair<FName, FCameraStyleConfiguration>& CustomStyle : CustomCameraStyles)
+	{
+		CustomStylesAllocated += CustomStyle.Value.Orientations.GetAllocatedSize();
+	}
+	OutBreakdown.Add(FBreakdown::ArmTable,
+		sizeof(CustomCameraStyles) + sizeof(CameraStyleIds) + sizeof(CameraArmTable) + sizeof(CameraStyleRotationModes) + sizeof(CameraArmBlend),
+		CustomStylesAllocated + CameraStyleIds.GetAllocatedSize() + CameraArmTable.GetAllocatedSize() + CameraStyleRotationModes.GetAllocatedSize()
+	);
+
+	OutBreakdown.Add(FBreakdown::Networking, sizeof(SpectatorView) + sizeof(SentSpectatorView) + sizeof(SpectatorViewBuffer) + sizeof(CameraViewHistory), 0);
+
+	// Everything else this class adds on top of a character
+	const SIZE_T ClassSize = GetClass()->GetStructureSize() - ACharacter::StaticClass()->GetStructureSize();
+	SIZE_T Counted = 0;
+	for (int32 Category = 0; Category < FBreakdown::NumCategories; ++Category)
+	{
+		if (Category != FBreakdown::Components) Counted += OutBreakdown.Inline[Category];
+	}
+	OutBreakdown.Add(FBreakdown::Other, ClassSize > Counted ? ClassSize - Counted : 0, 0);
+}
+
+
+void ACharacterCameraLogic::CheckCameraMemoryBudget() const
+{
+	const int32 Budget = CVarCameraMemoryBudget.GetValueOnGameThread();
+	if (Budget <= 0) return;
+
+	FCameraMemoryBreakdown Breakdown;
+	GetCameraMemoryBreakdown(Breakdown);
+	if (Breakdown.GetTotal() > static_cast<SIZE_T>(Budget))
+	{
+		UE_LOGFMT(CameraLog, Error, "{0} uses {1} bytes of camera memory, which is over the {2} byte budget (Camera.Memory.Budget). Run Camera.MemReport for the breakdown",
+			*GetName(), static_cast<uint64>(Breakdown.GetTotal()), Budget
+		);
+	}
+}
+
+
+const FCameraArmBlend& ACharacterCameraLogic::GetCameraArmBlend() const
+{
+	return CameraArmBlend;
+}
+
+
+void ACharacterCameraLogic::SetCameraArmBlend(const FCameraArmBlend& Blend)
+{
+	CameraArmBlend = Blend;
+}
+
+
+float ACharacterCameraLogic::GetTargetSwitchScoreMargin() const
+{
+	return TargetSwitchScoreMargin;
+}
+
+
 void ACharacterCameraLogic::SetTargetLockTransitionSpeed(const float Speed)
 {
 	TargetLockTransitionSpeed = Speed;
@@ -1,6 +1,9 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "CharacterCameraSystem.h"
+#include "PlayerCameraTypes.h"
+
+CSV_DEFINE_CATEGORY_MODULE(CHARACTERCAMERASYSTEM_API, CharacterCamera, true);
 
 #define LOCTEXT_NAMESPACE "FCharacterCameraSystemModule"
 
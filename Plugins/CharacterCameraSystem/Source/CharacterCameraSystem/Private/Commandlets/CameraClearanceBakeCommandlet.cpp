@@ -0,0 +1,122 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Commandlets/CameraClearanceBakeCommandlet.h"
+
+#include "Character/CharacterCameraLogic.h"
+#include "Data/CameraClearanceField.h"
+#include "Components/PrimitiveComponent.h"
+#include "EngineUtils.h"
+#include "Logging/StructuredLog.h"
+#include "Misc/PackageName.h"
+#include "UObject/Package.h"
+#include "UObject/SavePackage.h"
+
+
+UCameraClearanceBakeCommandlet::UCameraClearanceBakeCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+
+int32 UCameraClearanceBakeCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	TMap<FString, FString> ParamsMap;
+	ParseCommandLine(*Params, Tokens, Switches, ParamsMap);
+
+	const FString* MapName = ParamsMap.Find(TEXT("Map"));
+	const FString* AssetPath = ParamsMap.Find(TEXT("Asset"));
+	if (!MapName || !AssetPath)
+	{
+		UE_LOGFMT(CameraLog, Error, "Usage: -run=CameraClearanceBake -Map=<map package> -Asset=<asset package> [-CellSize=] [-ArmLength=] [-ProbeSize=] [-Padding=]");
+		return 1;
+	}
+
+	// Load the map and create it's collision
+	UPackage* MapPackage = LoadPackage(nullptr, **MapName, LOAD_None);
+	UWorld* World = MapPackage ? UWorld::FindWorldInPackage(MapPackage) : nullptr;
+	if (!World)
+	{
+		UE_LOGFMT(CameraLog, Error, "Failed to load the map {0}", **MapName);
+		return 1;
+	}
+
+	World->AddToRoot();
+	World->WorldType = EWorldType::Editor;
+	if (!World->bIsWorldInitialized)
+	{
+		World->InitWorld(UWorld::InitializationValues()
+			.RequiresHitProxies(false)
+			.ShouldSimulatePhysics(false)
+			.EnableTraceCollision(true)
+			.CreateNavigation(false)
+			.CreateAISystem(false)
+			.AllowAudioPlayback(false)
+			.CreatePhysicsScene(true));
+	}
+	World->UpdateWorldComponents(true, false);
+
+	// Find or create the clearance field
+	const FString AssetName = FPackageName::GetLongPackageAssetName(*AssetPath);
+	UCameraClearanceField* ClearanceField = LoadObject<UCameraClearanceField>(nullptr, *FString::Printf(TEXT("%s.%s"), **AssetPath, *AssetName), nullptr, LOAD_NoWarn);
+	if (!ClearanceField)
+	{
+		UPackage* AssetPackage = CreatePackage(**AssetPath);
+		ClearanceField = NewObject<UCameraClearanceField>(AssetPackage, FName(*AssetName), RF_Public | RF_Standalone);
+	}
+
+	FParse::Value(*Params, TEXT("CellSize="), ClearanceField->CellSize);
+	FParse::Value(*Params, TEXT("ArmLength="), ClearanceField->MaxArmLength);
+	FParse::Value(*Params, TEXT("ProbeSize="), ClearanceField->ProbeSize);
+	float Padding = ClearanceField->MaxArmLength;
+	FParse::Value(*Params, TEXT("Padding="), Padding);
+
+	const FBox Bounds = GetStaticGeometryBounds(World).ExpandBy(Padding);
+	UE_LOGFMT(CameraLog, Display, "Baking {0} over {1}", *ClearanceField->GetName(), *Bounds.ToString());
+
+	const bool bBaked = ClearanceField->Bake(World, Bounds);
+	World->DestroyWorld(false);
+	World->RemoveFromRoot();
+	if (!bBaked) return 1;
+
+	// Save the clearance field
+	UPackage* AssetPackage = ClearanceField->GetOutermost();
+	const FString Filename = FPackageName::LongPackageNameToFilename(AssetPackage->GetName(), FPackageName::GetAssetPackageExtension());
+	FSavePackageArgs SaveArgs;
+	SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+	if (!UPackage::SavePackage(AssetPackage, ClearanceField, *Filename, SaveArgs))
+	{
+		UE_LOGFMT(CameraLog, Error, "Failed to save {0}", *Filename);
+		return 1;
+	}
+
+	UE_LOGFMT(CameraLog, Display, "Saved {0}, {1} bytes of clearance data", *Filename, ClearanceField->GetClearanceDataSize());
+	return 0;
+#else
+	UE_LOGFMT(CameraLog, Error, "The camera clearance field can only be baked in the editor");
+	return 1;
+#endif
+}
+
+
+FBox UCameraClearanceBakeCommandlet::GetStaticGeometryBounds(UWorld* World) const
+{
+	FBox Bounds(ForceInit);
+	for (TActorIterator<AActor> It(World); It; ++It)
+	{
+		for (const UActorComponent* Component : It->GetComponents())
+		{
+			const UPrimitiveComponent* Primitive = Cast<UPrimitiveComponent>(Component);
+			if (!Primitive || Primitive->Mobility != EComponentMobility::Static || !Primitive->IsCollisionEnabled()) continue;
+			Bounds += Primitive->Bounds.GetBox();
+		}
+	}
+
+	return Bounds;
+}
@@ -0,0 +1,169 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Data/CameraClearanceField.h"
+
+#include "Logging/StructuredLog.h"
+#include "Character/CharacterCameraLogic.h"
+
+/** The largest grid that can be baked, in bytes */
+static constexpr int64 MaxClearanceDataSize = 256 * 1024 * 1024;
+
+
+UCameraClearanceField::UCameraClearanceField()
+{
+	Origin = FVector::ZeroVector;
+	CellSize = 100.0;
+	Dimensions = FIntVector::ZeroValue;
+	NumYawBuckets = 16;
+	NumPitchBuckets = 4;
+	MaxArmLength = 800.0;
+	ProbeSize = 16.4;
+	ProbeChannel = ECC_Camera;
+}
+
+
+bool UCameraClearanceField::GetMaxArmLength(const FVector& Location, const FVector& Direction, float& OutMaxArmLength) const
+{
+	const FVector GridLocation = (Location - Origin) / CellSize;
+	const int32 X = FMath::FloorToInt(GridLocation.X);
+	const int32 Y = FMath::FloorToInt(GridLocation.Y);
+	const int32 Z = FMath::FloorToInt(GridLocation.Z);
+	if (X < 0 || Y < 0 || Z < 0 || X >= Dimensions.X || Y >= Dimensions.Y || Z >= Dimensions.Z) return false;
+
+	const int32 NumBuckets = NumYawBuckets * NumPitchBuckets;
+	const int32 CellIndex = (Z * Dimensions.Y + Y) * Dimensions.X + X;
+	const int32 Index = CellIndex * NumBuckets + GetDirectionBucket(Direction);
+	if (!Clearance.IsValidIndex(Index)) return false;
+
+	OutMaxArmLength = Clearance[Index] * (MaxArmLength / 255.0f);
+	return true;
+}
+
+
+int32 UCameraClearanceField::GetDirectionBucket(const FVector& Direction) const
+{
+	const float Yaw = FMath::Atan2(Direction.Y, Direction.X);
+	const float Pitch = FMath::Asin(FMath::Clamp(Direction.Z, -1.0f, 1.0f));
+	const int32 YawBucket = FMath::FloorToInt((Yaw + UE_PI) / UE_TWO_PI * NumYawBuckets) % NumYawBuckets;
+	const int32 PitchBucket = FMath::Clamp(FMath::FloorToInt((Pitch + UE_HALF_PI) / UE_PI * NumPitchBuckets), 0, NumPitchBuckets - 1);
+	return PitchBucket * NumYawBuckets + YawBucket;
+}
+
+
+FVector UCameraClearanceField::GetBucketDirection(const int32 YawBucket, const int32 PitchBucket) const
+{
+	const float Yaw = (YawBucket + 0.5f) / NumYawBuckets * UE_TWO_PI - UE_PI;
+	const float Pitch = (PitchBucket + 0.5f) / NumPitchBuckets * UE_PI - UE_HALF_PI;
+	return FVector(FMath::Cos(Pitch) * FMath::Cos(Yaw), FMath::Cos(Pitch) * FMath::Sin(Yaw), FMath::Sin(Pitch));
+}
+
+
+bool UCameraClearanceField::Contains(const FVector& Location) const
+{
+	const FVector GridLocation = (Location - Origin) / CellSize;
+	return GridLocation.X >= 0.0 && GridLocation.Y >= 0.0 && GridLocation.Z >= 0.0
+		&& GridLocation.X < Dimensions.X && GridLocation.Y < Dimensions.Y && GridLocation.Z < Dimensions.Z;
+}
+
+
+bool UCameraClearanceField::IsBaked() const
+{
+	return !Clearance.IsEmpty();
+}
+
+
+int32 UCameraClearanceField::GetClearanceDataSize() const
+{
+	return Clearance.Num() * sizeof(uint8);
+}
+
+
+#if WITH_EDITOR
+bool UCameraClearanceField::Bake(UWorld* World, const FBox& Bounds)
+{
+	if (!World || !Bounds.IsValid) return false;
+
+	NumYawBuckets = FMath::Max(NumYawBuckets, 1);
+	NumPitchBuckets = FMath::Max(NumPitchBuckets, 1);
+	const int32 NumBuckets = NumYawBuckets * NumPitchBuckets;
+	const FVector Size = Bounds.GetSize();
+	const FIntVector NewDimensions(
+		FMath::Max(FMath::CeilToInt(Size.X / CellSize), 1),
+		FMath::Max(FMath::CeilToInt(Size.Y / CellSize), 1),
+		FMath::Max(FMath::CeilToInt(Size.Z / CellSize), 1)
+	);
+
+	const int64 DataSize = static_cast<int64>(NewDimensions.X) * NewDimensions.Y * NewDimensions.Z * NumBuckets;
+	if (DataSize > MaxClearanceDataSize)
+	{
+		UE_LOGFMT(CameraLog, Error, "{0}: the clearance field would be {1} bytes, increase the cell size or reduce the bounds", *GetName(), DataSize);
+		return false;
+	}
+
+	Origin = Bounds.Min;
+	Dimensions = NewDimensions;
+	Clearance.SetNumZeroed(DataSize);
+
+	// An arm from anywhere within the cell, in any direction within the bucket, stays inside a sweep along the bucket's center from the cell's center that's widened by the
+	// cell's half diagonal and by how far the bucket's edges spread from it's center. The spread grows with the length, so the arm is swept in segments that widen along the way
+	static constexpr int32 NumSegments = 8;
+	const float CellMargin = CellSize * UE_HALF_SQRT_3;
+	const float SegmentLength = MaxArmLength / NumSegments;
+	const float YawStep = UE_TWO_PI / NumYawBuckets;
+	const float PitchStep = UE_PI / NumPitchBuckets;
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(CameraClearanceBake), false);
+	QueryParams.MobilityType = EQueryMobilityType::Static;
+
+	for (int32 Z = 0; Z < Dimensions.Z; ++Z)
+	{
+		for (int32 Y = 0; Y < Dimensions.Y; ++Y)
+		{
+			for (int32 X = 0; X < Dimensions.X; ++X)
+			{
+				const FVector CellCenter = Origin + (FVector(X, Y, Z) + 0.5) * CellSize;
+				const int32 CellIndex = (Z * Dimensions.Y + Y) * Dimensions.X + X;
+
+				for (int32 PitchBucket = 0; PitchBucket < NumPitchBuckets; ++PitchBucket)
+				{
+					for (int32 YawBucket = 0; YawBucket < NumYawBuckets; ++YawBucket)
+					{
+						// The distance between two unit directions is the spread per unit of length, the corners are the furthest from the center
+						const FVector Center = GetBucketDirection(YawBucket, PitchBucket);
+						const FRotator BucketRotation = Center.Rotation();
+						float Spread = 0.0f;
+						for (const FVector2D Corner : { FVector2D(-0.5, -0.5), FVector2D(0.5, -0.5), FVector2D(-0.5, 0.5), FVector2D(0.5, 0.5) })
+						{
+							const FRotator CornerRotation = BucketRotation + FRotator(FMath::RadiansToDegrees(Corner.Y * PitchStep), FMath::RadiansToDegrees(Corner.X * YawStep), 0.0);
+							Spread = FMath::Max(Spread, static_cast<float>((CornerRotation.Vector() - Center).Size()));
+						}
+
+						float BucketClearance = MaxArmLength;
+						for (int32 Segment = 0; Segment < NumSegments; ++Segment)
+						{
+							const float SegmentStart = Segment * SegmentLength;
+							const float SegmentEnd = SegmentStart + SegmentLength;
+							const FCollisionShape Probe = FCollisionShape::MakeSphere(ProbeSize + CellMargin + SegmentEnd * Spread);
+
+							FHitResult Hit;
+							if (World->SweepSingleByChannel(Hit, CellCenter + Center * SegmentStart, CellCenter + Center * SegmentEnd, FQuat::Identity, ProbeChannel, Probe, QueryParams))
+							{
+								BucketClearance = Hit.bStartPenetrating ? SegmentStart : SegmentStart + Hit.Distance;
+								break;
+							}
+						}
+
+						const int32 Quantized = FMath::FloorToInt(FMath::Max(BucketClearance, 0.0f) / MaxArmLength * 255.0f);
+						Clearance[CellIndex * NumBuckets + PitchBucket * NumYawBuckets + YawBucket] = static_cast<uint8>(FMath::Clamp(Quantized, 0, 255));
+					}
+				}
+			}
+		}
+
+		UE_LOGFMT(CameraLog, Display, "{0}: baked {1}/{2} layers", *GetName(), Z + 1, Dimensions.Z);
+	}
+
+	MarkPackageDirty();
+	return true;
+}
+#endif
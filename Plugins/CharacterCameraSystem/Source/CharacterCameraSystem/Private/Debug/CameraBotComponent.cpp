@@ -0,0 +1,113 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Debug/CameraBotComponent.h"
+
+#include "Character/CharacterCameraLogic.h"
+#include "EngineUtils.h"
+
+
+UCameraBotComponent::UCameraBotComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = true;
+
+	StyleSwitchInterval = FVector2D(2.0, 6.0);
+	OrientationSwapInterval = FVector2D(1.0, 4.0);
+	TargetCycleInterval = FVector2D(0.25, 1.5);
+	TargetRadius = 3000.0;
+	LookSpeed = 45.0;
+	Styles = { CameraStyle_ThirdPerson, CameraStyle_TargetLocking, CameraStyle_FirstPerson, CameraStyle_Aiming };
+}
+
+
+void UCameraBotComponent::BeginPlay()
+{
+	Super::BeginPlay();
+	Character = Cast<ACharacterCameraLogic>(GetOwner());
+
+	int32 Seed = 0;
+	FParse::Value(FCommandLine::Get(), TEXT("CameraBotSeed="), Seed);
+	Stream.Initialize(Seed != 0 ? Seed : FMath::Rand());
+
+	NextStyleSwitch = GetRandomInterval(StyleSwitchInterval);
+	NextOrientationSwap = GetRandomInterval(OrientationSwapInterval);
+	NextTargetCycle = GetRandomInterval(TargetCycleInterval);
+}
+
+
+void UCameraBotComponent::TickComponent(const float DeltaTime, const ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	if (!Character || !Character->IsLocallyControlled()) return;
+
+	UpdateMovement(DeltaTime);
+
+	NextStyleSwitch -= DeltaTime;
+	if (NextStyleSwitch <= 0.0f)
+	{
+		SwitchStyle();
+		NextStyleSwitch = GetRandomInterval(StyleSwitchInterval);
+	}
+
+	NextOrientationSwap -= DeltaTime;
+	if (NextOrientationSwap <= 0.0f)
+	{
+		SwapOrientation();
+		NextOrientationSwap = GetRandomInterval(OrientationSwapInterval);
+	}
+
+	NextTargetCycle -= DeltaTime;
+	if (NextTargetCycle <= 0.0f)
+	{
+		CycleTarget();
+		NextTargetCycle = GetRandomInterval(TargetCycleInterval);
+	}
+}
+
+
+void UCameraBotComponent::SwitchStyle()
+{
+	if (Styles.IsEmpty()) return;
+	Character->Execute_SetCameraStyle(Character, Styles[Stream.RandHelper(Styles.Num())]);
+	Character->OnCameraStyleSet();
+}
+
+
+void UCameraBotComponent::SwapOrientation()
+{
+	static const ECameraOrientation Orientations[] = { ECameraOrientation::Center, ECameraOrientation::LeftShoulder, ECameraOrientation::RightShoulder };
+	Character->Execute_SetCameraOrientation(Character, Orientations[Stream.RandHelper(UE_ARRAY_COUNT(Orientations))]);
+}
+
+
+void UCameraBotComponent::CycleTarget()
+{
+	if (Character->Execute_GetCameraStyle(Character) != CameraStyle_TargetLocking) return;
+
+	TArray<AActor*>& Targets = Character->GetTargetLockCharactersReference();
+	Targets.Reset();
+	const FVector Location = Character->GetActorLocation();
+	for (TActorIterator<ACharacterCameraLogic> It(GetWorld()); It; ++It)
+	{
+		if (*It == Character || FVector::DistSquared(It->GetActorLocation(), Location) > FMath::Square(TargetRadius)) continue;
+		Targets.Add(*It);
+	}
+
+	TArray<AActor*> ActorsToIgnore;
+	Character->AdjustCurrentTarget(ActorsToIgnore, Stream.FRand() < 0.5f ? EPreviousTargetLockOrientation::Left : EPreviousTargetLockOrientation::Right, TargetRadius);
+}
+
+
+void UCameraBotComponent::UpdateMovement(const float DeltaTime)
+{
+	// Wander in a slow circle so the camera lag, collision and replication all have something to do
+	Character->AddControllerYawInput(LookSpeed * DeltaTime * (Stream.FRand() < 0.02f ? -4.0f : 1.0f));
+	Character->AddMovementInput(Character->GetControlRotation().Vector().GetSafeNormal2D());
+}
+
+
+float UCameraBotComponent::GetRandomInterval(const FVector2D& Interval) const
+{
+	return Stream.FRandRange(Interval.X, Interval.Y);
+}
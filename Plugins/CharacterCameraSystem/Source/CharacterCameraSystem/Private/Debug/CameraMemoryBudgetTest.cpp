@@ -0,0 +1,54 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PlayerCameraTypes.h"
+#include "Character/CharacterCameraLogic.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/** The budget that's used when Camera.Memory.Budget isn't set */
+static constexpr int32 DefaultCameraMemoryTestBudget = 64 * 1024;
+
+
+/**
+ * Spawns a camera character in an empty game world and checks it's camera memory against Camera.Memory.Budget, so anything that grows the character past the budget fails automation
+ * instead of only logging an error at runtime. @see ACharacterCameraLogic::GetCameraMemoryBreakdown
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCameraMemoryBudgetTest, "CharacterCameraSystem.Memory.Budget", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FCameraMemoryBudgetTest::RunTest(const FString& Parameters)
+{
+	const IConsoleVariable* BudgetVariable = IConsoleManager::Get().FindConsoleVariable(TEXT("Camera.Memory.Budget"));
+	const int32 ConfiguredBudget = BudgetVariable ? BudgetVariable->GetInt() : 0;
+	const int32 Budget = ConfiguredBudget > 0 ? ConfiguredBudget : DefaultCameraMemoryTestBudget;
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+	World->InitializeActorsForPlay(FURL());
+	World->BeginPlay();
+
+	const ACharacterCameraLogic* Character = World->SpawnActor<ACharacterCameraLogic>();
+	if (TestNotNull(TEXT("Spawned camera character"), Character))
+	{
+		FCameraMemoryBreakdown Breakdown;
+		Character->GetCameraMemoryBreakdown(Breakdown);
+		for (int32 Category = 0; Category < FCameraMemoryBreakdown::NumCategories; ++Category)
+		{
+			const FCameraMemoryBreakdown::ECategory CategoryType = static_cast<FCameraMemoryBreakdown::ECategory>(Category);
+			AddInfo(FString::Printf(TEXT("%s: %llu inline, %llu allocated"), FCameraMemoryBreakdown::GetCategoryName(CategoryType), static_cast<uint64>(Breakdown.Inline[Category]), static_cast<uint64>(Breakdown.Allocated[Category])));
+		}
+
+		TestTrue(FString::Printf(TEXT("Camera memory (%llu bytes) is within the %d byte budget"), static_cast<uint64>(Breakdown.GetTotal()), Budget), Breakdown.GetTotal() <= static_cast<SIZE_T>(Budget));
+	}
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	return true;
+}
+
+#endif
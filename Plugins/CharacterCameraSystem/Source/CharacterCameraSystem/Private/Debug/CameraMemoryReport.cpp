@@ -0,0 +1,65 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PlayerCameraTypes.h"
+#include "Character/CharacterCameraLogic.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+
+
+namespace CameraMemoryReport
+{
+	static void LogBreakdown(FOutputDevice& Ar, const TCHAR* Name, const FCameraMemoryBreakdown& Breakdown)
+	{
+		FString Categories;
+		for (int32 Category = 0; Category < FCameraMemoryBreakdown::NumCategories; ++Category)
+		{
+			const FCameraMemoryBreakdown::ECategory CategoryType = static_cast<FCameraMemoryBreakdown::ECategory>(Category);
+			Categories += FString::Printf(TEXT(", %s %llu"), FCameraMemoryBreakdown::GetCategoryName(CategoryType), static_cast<uint64>(Breakdown.GetTotal(CategoryType)));
+		}
+
+		Ar.Logf(TEXT("  %-48s %10llu bytes%s"), Name, static_cast<uint64>(Breakdown.GetTotal()), *Categories);
+	}
+
+
+	/** Logs the camera memory of each camera character in the world, and the totals of each category. This is also part of memreport's output */
+	static void Run(const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+	{
+		if (!World) return;
+		const int32 NumCharacters = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 20;
+
+		TArray<TPair<const ACharacterCameraLogic*, FCameraMemoryBreakdown>> Characters;
+		FCameraMemoryBreakdown Total;
+		for (TActorIterator<ACharacterCameraLogic> It(World); It; ++It)
+		{
+			FCameraMemoryBreakdown& Breakdown = Characters.Emplace_GetRef(*It, FCameraMemoryBreakdown()).Value;
+			It->GetCameraMemoryBreakdown(Breakdown);
+			Total += Breakdown;
+		}
+
+		Characters.Sort([](const auto& A, const auto& B) { return A.Value.GetTotal() > B.Value.GetTotal(); });
+
+		Ar.Logf(TEXT("Camera memory: %d characters, %llu bytes (%llu bytes each)"),
+			Characters.Num(), static_cast<uint64>(Total.GetTotal()), static_cast<uint64>(Characters.Num() > 0 ? Total.GetTotal() / Characters.Num() : 0)
+		);
+
+		for (int32 Category = 0; Category < FCameraMemoryBreakdown::NumCategories; ++Category)
+		{
+			const FCameraMemoryBreakdown::ECategory CategoryType = static_cast<FCameraMemoryBreakdown::ECategory>(Category);
+			Ar.Logf(TEXT("  %-16s %10llu inline %10llu allocated"), FCameraMemoryBreakdown::GetCategoryName(CategoryType), static_cast<uint64>(Total.Inline[Category]), static_cast<uint64>(Total.Allocated[Category]));
+		}
+
+		Ar.Logf(TEXT("Largest camera characters:"));
+		for (int32 Index = 0; Index < FMath::Min(NumCharacters, Characters.Num()); ++Index)
+		{
+			LogBreakdown(Ar, *Characters[Index].Key->GetName(), Characters[Index].Value);
+		}
+	}
+}
+
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice CameraMemReportCommand(
+	TEXT("Camera.MemReport"),
+	TEXT("Logs the memory the camera system adds to each camera character, and the totals by category. Camera.MemReport [Count]"),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateStatic(&CameraMemoryReport::Run)
+);
@@ -0,0 +1,240 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Debug/CameraNetProfiler.h"
+
+#include "PlayerCameraTypes.h"
+#include "Character/CharacterCameraLogic.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "Engine/ActorChannel.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "Logging/StructuredLog.h"
+#include "ProfilingDebugging/CountersTrace.h"
+
+#if WITH_CAMERA_NET_PROFILER
+DECLARE_DWORD_COUNTER_STAT(TEXT("Camera Net Sent"), STAT_CameraNetSent, STATGROUP_CharacterCamera);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Camera Net Received"), STAT_CameraNetReceived, STATGROUP_CharacterCamera);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Camera Net Estimated Bytes"), STAT_CameraNetBytes, STATGROUP_CharacterCamera);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Camera Net Throttled"), STAT_CameraNetThrottled, STATGROUP_CharacterCamera);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Camera Net Saturated"), STAT_CameraNetSaturated, STATGROUP_CharacterCamera);
+
+TRACE_DECLARE_INT_COUNTER(CameraNetSent, TEXT("Camera/Net/Sent"));
+TRACE_DECLARE_INT_COUNTER(CameraNetReceived, TEXT("Camera/Net/Received"));
+TRACE_DECLARE_INT_COUNTER(CameraNetBytes, TEXT("Camera/Net/EstimatedBytes"));
+TRACE_DECLARE_INT_COUNTER(CameraNetThrottled, TEXT("Camera/Net/Throttled"));
+TRACE_DECLARE_INT_COUNTER(CameraNetSaturated, TEXT("Camera/Net/Saturated"));
+
+
+namespace CameraNetProfiler
+{
+	/** The counters of each camera RPC and property on a connection */
+	struct FConnection
+	{
+		TMap<FName, FCameraNetCounters> Counters;
+	};
+
+	/** The counters of each connection, keyed by the connection's description. These are only accessed on the game thread */
+	static TMap<FString, FConnection> Connections;
+
+	/** When the counters were last reset */
+	static double StartTime = FPlatformTime::Seconds();
+
+
+	static FString DescribeConnection(const UNetConnection* Connection)
+	{
+		const FString Address = const_cast<UNetConnection*>(Connection)->LowLevelGetRemoteAddress(true);
+		const APlayerController* PlayerController = Connection->PlayerController;
+		return PlayerController ? FString::Printf(TEXT("%s (%s)"), *PlayerController->GetName(), *Address) : Address;
+	}
+
+	/** Returns the connection an actor's networking goes over, which is the server connection on clients and the owning connection on the server */
+	static UNetConnection* GetRemoteConnection(const AActor* Actor)
+	{
+		if (Actor->GetNetMode() == NM_Client)
+		{
+			const UNetDriver* NetDriver = Actor->GetNetDriver();
+			return NetDriver ? NetDriver->ServerConnection : nullptr;
+		}
+
+		return Actor->GetNetConnection();
+	}
+
+
+	/** Adds an event to the counters of a connection */
+	static void RecordConnection(const UNetConnection* Connection, const FName Name, const ECameraNetEvent Event, const int32 Bytes)
+	{
+		const FString ConnectionName = Connection ? DescribeConnection(Connection) : FString(TEXT("None"));
+		FCameraNetCounters& Counters = Connections.FindOrAdd(ConnectionName).Counters.FindOrAdd(Name);
+		switch (Event)
+		{
+		case ECameraNetEvent::Sent:
+			++Counters.Sent;
+			Counters.Bytes += Bytes;
+			INC_DWORD_STAT(STAT_CameraNetSent);
+			INC_DWORD_STAT_BY(STAT_CameraNetBytes, Bytes);
+			TRACE_COUNTER_INCREMENT(CameraNetSent);
+			TRACE_COUNTER_ADD(CameraNetBytes, Bytes);
+			CSV_CUSTOM_STAT(CharacterCamera, NetSent, 1, ECsvCustomStatOp::Accumulate);
+			CSV_CUSTOM_STAT(CharacterCamera, NetEstimatedBytes, Bytes, ECsvCustomStatOp::Accumulate);
+			break;
+
+		case ECameraNetEvent::Received:
+			++Counters.Received;
+			Counters.Bytes += Bytes;
+			INC_DWORD_STAT(STAT_CameraNetReceived);
+			INC_DWORD_STAT_BY(STAT_CameraNetBytes, Bytes);
+			TRACE_COUNTER_INCREMENT(CameraNetReceived);
+			TRACE_COUNTER_ADD(CameraNetBytes, Bytes);
+			CSV_CUSTOM_STAT(CharacterCamera, NetReceived, 1, ECsvCustomStatOp::Accumulate);
+			CSV_CUSTOM_STAT(CharacterCamera, NetEstimatedBytes, Bytes, ECsvCustomStatOp::Accumulate);
+			break;
+
+		case ECameraNetEvent::Throttled:
+			++Counters.Throttled;
+			INC_DWORD_STAT(STAT_CameraNetThrottled);
+			TRACE_COUNTER_INCREMENT(CameraNetThrottled);
+			CSV_CUSTOM_STAT(CharacterCamera, NetThrottled, 1, ECsvCustomStatOp::Accumulate);
+			break;
+
+		case ECameraNetEvent::Saturated:
+			++Counters.Saturated;
+			INC_DWORD_STAT(STAT_CameraNetSaturated);
+			TRACE_COUNTER_INCREMENT(CameraNetSaturated);
+			CSV_CUSTOM_STAT(CharacterCamera, NetSaturated, 1, ECsvCustomStatOp::Accumulate);
+			break;
+		}
+	}
+}
+
+
+static FAutoConsoleCommand CameraNetDumpCommand(
+	TEXT("Camera.Net.Dump"),
+	TEXT("Logs the connections and camera RPCs with the most traffic. Camera.Net.Dump [Count]"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		FCameraNetProfiler::Dump(Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 10);
+	})
+);
+
+static FAutoConsoleCommand CameraNetResetCommand(
+	TEXT("Camera.Net.Reset"),
+	TEXT("Clears the camera networking counters"),
+	FConsoleCommandDelegate::CreateStatic(&FCameraNetProfiler::Reset)
+);
+#endif
+
+
+void FCameraNetProfiler::Record(const AActor* Actor, const FName Name, const ECameraNetEvent Event, const int32 Bytes)
+{
+#if WITH_CAMERA_NET_PROFILER
+	check(IsInGameThread());
+	if (!Actor || Actor->GetNetMode() == NM_Standalone) return;
+
+	// Local calls on the server don't go over a connection, property sends are recorded with RecordReplicated
+	if (Event != ECameraNetEvent::Received && Actor->HasAuthority()) return;
+
+	const UNetConnection* Connection = CameraNetProfiler::GetRemoteConnection(Actor);
+	if (!Connection && Event != ECameraNetEvent::Saturated) return;
+
+	CameraNetProfiler::RecordConnection(Connection, Name, Event, Bytes);
+#endif
+}
+
+
+void FCameraNetProfiler::RecordReplicated(const AActor* Actor, const FName Name, const ELifetimeCondition Condition, const int32 Bytes)
+{
+#if WITH_CAMERA_NET_PROFILER
+	check(IsInGameThread());
+	if (!Actor || !Actor->HasAuthority() || Actor->GetNetMode() == NM_Standalone) return;
+
+	const UNetDriver* NetDriver = Actor->GetNetDriver();
+	if (!NetDriver) return;
+
+	// The connections are estimated from the open actor channels and the owner condition. Relevancy and the net update rate aren't known until the driver replicates the actor
+	const UNetConnection* OwningConnection = Actor->GetNetConnection();
+	for (UNetConnection* Connection : NetDriver->ClientConnections)
+	{
+		if (!Connection || !Connection->FindActorChannelRef(const_cast<AActor*>(Actor))) continue;
+
+		const bool bIsOwner = Connection == OwningConnection;
+		if (Condition == COND_OwnerOnly && !bIsOwner) continue;
+		if (Condition == COND_SkipOwner && bIsOwner) continue;
+
+		CameraNetProfiler::RecordConnection(Connection, Name, ECameraNetEvent::Sent, Bytes);
+	}
+#endif
+}
+
+
+ECameraNetEvent FCameraNetProfiler::GetUnreliableSendEvent(const AActor* Actor)
+{
+	UNetConnection* Connection = Actor ? Actor->GetNetConnection() : nullptr;
+	return Connection && Connection->IsNetReady(false) ? ECameraNetEvent::Sent : ECameraNetEvent::Saturated;
+}
+
+
+void FCameraNetProfiler::Dump(const int32 NumEntries)
+{
+#if WITH_CAMERA_NET_PROFILER
+	struct FEntry
+	{
+		const FString* Connection;
+		FName Name;
+		const FCameraNetCounters* Counters;
+	};
+
+	TArray<FEntry> Entries;
+	uint64 TotalBytes = 0;
+	for (const TPair<FString, CameraNetProfiler::FConnection>& Connection : CameraNetProfiler::Connections)
+	{
+		for (const TPair<FName, FCameraNetCounters>& Counters : Connection.Value.Counters)
+		{
+			Entries.Add({ &Connection.Key, Counters.Key, &Counters.Value });
+			TotalBytes += Counters.Value.Bytes;
+		}
+	}
+
+	Entries.Sort([](const FEntry& A, const FEntry& B) { return A.Counters->Bytes > B.Counters->Bytes; });
+
+	const double Duration = FMath::Max(FPlatformTime::Seconds() - CameraNetProfiler::StartTime, 0.001);
+	UE_LOGFMT(CameraLog, Display, "Camera networking over {0}s: {1} connections, {2} estimated bytes ({3} bytes/s)",
+		Duration, CameraNetProfiler::Connections.Num(), TotalBytes, TotalBytes / Duration
+	);
+
+	for (int32 Index = 0; Index < FMath::Min(NumEntries, Entries.Num()); ++Index)
+	{
+		const FEntry& Entry = Entries[Index];
+		const FCameraNetCounters& Counters = *Entry.Counters;
+		UE_LOGFMT(CameraLog, Display, "  {0} {1}: {2} sent, {3} received, {4} estimated bytes ({5} bytes/s), {6} throttled, {7} sent while saturated",
+			**Entry.Connection, Entry.Name, Counters.Sent, Counters.Received, Counters.Bytes, Counters.Bytes / Duration, Counters.Throttled, Counters.Saturated
+		);
+	}
+#endif
+}
+
+
+void FCameraNetProfiler::Reset()
+{
+#if WITH_CAMERA_NET_PROFILER
+	CameraNetProfiler::Connections.Empty();
+	CameraNetProfiler::StartTime = FPlatformTime::Seconds();
+#endif
+}
+
+
+int32 FCameraNetProfiler::EstimateNameSize(const FName Name)
+{
+	const EName* HardcodedName = Name.ToEName();
+	if (HardcodedName && ShouldReplicateAsInteger(*HardcodedName, Name)) return 2;
+
+	// The string with it's length, and the name's number
+	return 4 + Name.GetPlainNameString().Len() + 1 + 4;
+}
+
+
+int32 FCameraNetProfiler::EstimateObjectSize(const UObject* Object)
+{
+	return Object ? 4 : 1;
+}
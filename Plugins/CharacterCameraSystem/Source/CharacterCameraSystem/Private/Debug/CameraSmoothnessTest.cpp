@@ -0,0 +1,432 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PlayerCameraTypes.h"
+#include "Algo/BinarySearch.h"
+#include "CameraComponents/BasePlayerCameraManager.h"
+#include "Character/CharacterCameraLogic.h"
+#include "Engine/Engine.h"
+#include "Engine/TargetPoint.h"
+#include "Engine/World.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+static TAutoConsoleVariable<float> CVarCameraSmoothnessMaxDivergence(
+	TEXT("Camera.Smoothness.MaxDivergence"),
+	5.0f,
+	TEXT("The furthest a run can diverge from the 240hz reference, as a percent of the scenario's travel"),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<float> CVarCameraSmoothnessMaxOvershoot(
+	TEXT("Camera.Smoothness.MaxOvershoot"),
+	2.0f,
+	TEXT("How much further than the reference a run can overshoot, as a percent of the scenario's travel"),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<float> CVarCameraSmoothnessMaxSettleTimeDelta(
+	TEXT("Camera.Smoothness.MaxSettleTimeDelta"),
+	0.1f,
+	TEXT("How much longer or shorter than the reference a run can take to settle, in seconds"),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<float> CVarCameraSmoothnessMaxJerkRatio(
+	TEXT("Camera.Smoothness.MaxJerkRatio"),
+	4.0f,
+	TEXT("How many times the reference's RMS jerk a run can have"),
+	ECVF_Default
+);
+
+
+namespace CameraSmoothness
+{
+	/** A recorded frame of the character's input. The location and control rotation are interpolated between keys, and the style, orientation and target are held until the next key */
+	struct FInputKey
+	{
+		float Time;
+		FVector Location;
+		FRotator ControlRotation;
+		FName Style;
+		ECameraOrientation Orientation;
+
+		/** The index of the scenario's target that's locked on to, or INDEX_NONE */
+		int32 Target;
+	};
+
+	/** A recorded input and target track */
+	struct FScenario
+	{
+		const TCHAR* Name;
+		float Duration;
+
+		/** When the input changes, the settle time and overshoot are measured after this */
+		float StepTime;
+
+		/** Measures the camera's rotation (yaw and pitch) instead of it's location */
+		bool bMeasureRotation;
+
+		/** Where the target lock targets are placed */
+		TArray<FVector> Targets;
+
+		TArray<FInputKey> Keys;
+	};
+
+	/** How the frames of a run are timed */
+	struct FFrameRate
+	{
+		const TCHAR* Name;
+		float DeltaTime;
+
+		/** The random variation of each frame, as a fraction of the delta time */
+		float Jitter;
+
+		/** A hitch of this length is added every second */
+		float HitchTime;
+	};
+
+	/** The world a run is played in */
+	struct FRun
+	{
+		UWorld* World = nullptr;
+		APlayerController* Controller = nullptr;
+		ACharacterCameraLogic* Character = nullptr;
+		TArray<AActor*> Targets;
+	};
+
+	struct FSample
+	{
+		float Time;
+		FVector Value;
+	};
+
+	struct FMetrics
+	{
+		float Divergence = 0.0f;
+		float Overshoot = 0.0f;
+		float SettleTime = 0.0f;
+		float Jerk = 0.0f;
+	};
+
+
+	/** How long the first key is held before a run starts, so every run starts from the same settled camera */
+	static constexpr float WarmUpTime = 2.0f;
+
+	static const FFrameRate ReferenceFrameRate = { TEXT("240hz"), 1.0f / 240.0f, 0.0f, 0.0f };
+
+	static const FFrameRate FrameRates[] =
+	{
+		{ TEXT("30hz"), 1.0f / 30.0f, 0.0f, 0.0f },
+		{ TEXT("60hz"), 1.0f / 60.0f, 0.0f, 0.0f },
+		{ TEXT("144hz"), 1.0f / 144.0f, 0.0f, 0.0f },
+		{ TEXT("60hz jittered"), 1.0f / 60.0f, 0.35f, 0.0f },
+		{ TEXT("60hz hitches"), 1.0f / 60.0f, 0.1f, 0.1f }
+	};
+
+
+	static TArray<FScenario> MakeScenarios()
+	{
+		const FName ThirdPerson = CameraStyle_ThirdPerson;
+		const FName TargetLocking = CameraStyle_TargetLocking;
+		const ECameraOrientation Right = ECameraOrientation::RightShoulder;
+		const ECameraOrientation Left = ECameraOrientation::LeftShoulder;
+
+		TArray<FScenario> Scenarios;
+
+		// Running forward, then stopping
+		Scenarios.Add({ TEXT("MoveStop"), 4.0f, 1.5f, false, {},
+			{
+				{ 0.0f, FVector::ZeroVector, FRotator::ZeroRotator, ThirdPerson, Right, INDEX_NONE },
+				{ 1.5f, FVector(900.0, 0.0, 0.0), FRotator::ZeroRotator, ThirdPerson, Right, INDEX_NONE }
+			}
+		});
+
+		// A quick look flick
+		Scenarios.Add({ TEXT("LookFlick"), 3.0f, 0.5f, true, {},
+			{
+				{ 0.0f, FVector::ZeroVector, FRotator::ZeroRotator, ThirdPerson, Right, INDEX_NONE },
+				{ 0.5f, FVector::ZeroVector, FRotator::ZeroRotator, ThirdPerson, Right, INDEX_NONE },
+				{ 0.6f, FVector::ZeroVector, FRotator(-20.0, 90.0, 0.0), ThirdPerson, Right, INDEX_NONE }
+			}
+		});
+
+		// Switching between two locked targets
+		Scenarios.Add({ TEXT("TargetSwitch"), 4.0f, 1.0f, true, { FVector(1000.0, -400.0, 100.0), FVector(600.0, 900.0, 300.0) },
+			{
+				{ 0.0f, FVector::ZeroVector, FRotator::ZeroRotator, TargetLocking, Right, 0 },
+				{ 1.0f, FVector::ZeroVector, FRotator::ZeroRotator, TargetLocking, Right, 1 }
+			}
+		});
+
+		// Swapping from the right shoulder to the left shoulder
+		Scenarios.Add({ TEXT("ShoulderSwap"), 3.0f, 0.5f, false, {},
+			{
+				{ 0.0f, FVector::ZeroVector, FRotator::ZeroRotator, ThirdPerson, Right, INDEX_NONE },
+				{ 0.5f, FVector::ZeroVector, FRotator::ZeroRotator, ThirdPerson, Left, INDEX_NONE }
+			}
+		});
+
+		return Scenarios;
+	}
+
+
+	/** Spawns a camera manager, and a character for it to view, in a new game world */
+	static void BeginRun(const FScenario& Scenario, FRun& Run)
+	{
+		Run.World = UWorld::CreateWorld(EWorldType::Game, false);
+		FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+		WorldContext.SetCurrentWorld(Run.World);
+		Run.World->InitializeActorsForPlay(FURL());
+		Run.World->BeginPlay();
+
+		Run.Controller = Run.World->SpawnActorDeferred<APlayerController>(APlayerController::StaticClass(), FTransform::Identity);
+		Run.Controller->PlayerCameraManagerClass = ABasePlayerCameraManager::StaticClass();
+		Run.Controller->FinishSpawning(FTransform::Identity);
+
+		// There's no local player, so the camera is updated as if it was the server's
+		Run.Controller->PlayerCameraManager->bUseClientSideCameraUpdates = false;
+
+		// The track places the character, so it isn't moved by gravity or it's movement
+		Run.Character = Run.World->SpawnActor<ACharacterCameraLogic>(Scenario.Keys[0].Location, FRotator::ZeroRotator);
+		Run.Character->GetCharacterMovement()->SetMovementMode(MOVE_None);
+		Run.Controller->Possess(Run.Character);
+
+		for (const FVector& Location : Scenario.Targets)
+		{
+			Run.Targets.Add(Run.World->SpawnActor<ATargetPoint>(Location, FRotator::ZeroRotator));
+		}
+	}
+
+
+	static void EndRun(FRun& Run)
+	{
+		GEngine->DestroyWorldContext(Run.World);
+		Run.World->DestroyWorld(false);
+		Run = FRun();
+	}
+
+
+	/** Applies the track's input at a time to the character, the same way the character's input would */
+	static void ApplyInput(const FScenario& Scenario, const FRun& Run, const float Time)
+	{
+		const int32 NextIndex = Algo::UpperBoundBy(Scenario.Keys, Time, &FInputKey::Time);
+		const FInputKey& Key = Scenario.Keys[FMath::Max(NextIndex - 1, 0)];
+
+		FVector Location = Key.Location;
+		FRotator ControlRotation = Key.ControlRotation;
+		if (NextIndex > 0 && NextIndex < Scenario.Keys.Num())
+		{
+			const FInputKey& Next = Scenario.Keys[NextIndex];
+			const float Alpha = (Time - Key.Time) / FMath::Max(Next.Time - Key.Time, UE_SMALL_NUMBER);
+			Location = FMath::Lerp(Key.Location, Next.Location, Alpha);
+			ControlRotation = FMath::Lerp(Key.ControlRotation, Next.ControlRotation, Alpha);
+		}
+
+		ACharacterCameraLogic* Character = Run.Character;
+		Character->SetActorLocation(Location);
+		Run.Controller->SetControlRotation(ControlRotation);
+
+		// Style switches that are throttled are tried again the next frame, like a held input
+		if (Character->Execute_GetCameraStyle(Character) != Key.Style)
+		{
+			Character->Execute_SetCameraStyle(Character, Key.Style);
+			Character->OnCameraStyleSet();
+		}
+
+		if (Character->Execute_GetCameraOrientation(Character) != Key.Orientation)
+		{
+			Character->Execute_SetCameraOrientation(Character, Key.Orientation);
+		}
+
+		AActor* Target = Run.Targets.IsValidIndex(Key.Target) ? Run.Targets[Key.Target] : nullptr;
+		if (Character->GetCurrentTarget() != Target)
+		{
+			Character->ApplyTargetSelection(Target);
+		}
+	}
+
+
+	/** Ticks the world, which ticks the character and then updates the camera manager */
+	static void TickRun(const FRun& Run, const float DeltaTime)
+	{
+		Run.World->Tick(LEVELTICK_All, DeltaTime);
+
+		// The timers only tick once a frame, so each tick is counted as a new frame
+		++GFrameCounter;
+	}
+
+
+	/** Returns the measured value of the camera manager's view. Rotations are unwound from the previous sample so they don't wrap */
+	static FVector GetSampleValue(const FScenario& Scenario, const FRun& Run, const FVector& PreviousValue)
+	{
+		const APlayerCameraManager* CameraManager = Run.Controller->PlayerCameraManager;
+		if (!Scenario.bMeasureRotation) return CameraManager->GetCameraLocation();
+
+		const FRotator Rotation = CameraManager->GetCameraRotation();
+		return FVector(
+			PreviousValue.X + FRotator::NormalizeAxis(Rotation.Yaw - PreviousValue.X),
+			PreviousValue.Y + FRotator::NormalizeAxis(Rotation.Pitch - PreviousValue.Y),
+			0.0
+		);
+	}
+
+
+	/** Plays a scenario at a frame rate */
+	static void Simulate(const FScenario& Scenario, const FFrameRate& FrameRate, TArray<FSample>& OutSamples)
+	{
+		FRun Run;
+		BeginRun(Scenario, Run);
+
+		// The warm up is always played at the reference rate, so the runs only differ once the track starts
+		for (float WarmUp = 0.0f; WarmUp < WarmUpTime; WarmUp += ReferenceFrameRate.DeltaTime)
+		{
+			ApplyInput(Scenario, Run, 0.0f);
+			TickRun(Run, ReferenceFrameRate.DeltaTime);
+		}
+
+		OutSamples.Reset();
+		OutSamples.Add({ 0.0f, GetSampleValue(Scenario, Run, FVector::ZeroVector) });
+
+		// The frame times are seeded, so every run of a frame rate is the same
+		FRandomStream Stream(1337);
+		float Time = 0.0f;
+		float NextHitch = 1.0f;
+		while (Time < Scenario.Duration)
+		{
+			float DeltaTime = FrameRate.DeltaTime * (1.0f + Stream.FRandRange(-FrameRate.Jitter, FrameRate.Jitter));
+			if (FrameRate.HitchTime > 0.0f && Time + DeltaTime >= NextHitch)
+			{
+				DeltaTime += FrameRate.HitchTime;
+				NextHitch += 1.0f;
+			}
+
+			Time += DeltaTime;
+			ApplyInput(Scenario, Run, Time);
+			TickRun(Run, DeltaTime);
+			OutSamples.Add({ Time, GetSampleValue(Scenario, Run, OutSamples.Last().Value) });
+		}
+
+		EndRun(Run);
+	}
+
+
+	/** Returns the value of a run at a time, interpolated between it's samples */
+	static FVector GetValueAtTime(const TArray<FSample>& Samples, const float Time)
+	{
+		const int32 Index = Algo::LowerBoundBy(Samples, Time, &FSample::Time);
+		if (Index <= 0) return Samples[0].Value;
+		if (Index >= Samples.Num()) return Samples.Last().Value;
+
+		const FSample& Previous = Samples[Index - 1];
+		const FSample& Next = Samples[Index];
+		const float Alpha = (Time - Previous.Time) / FMath::Max(Next.Time - Previous.Time, UE_SMALL_NUMBER);
+		return FMath::Lerp(Previous.Value, Next.Value, Alpha);
+	}
+
+
+	/** Measures a run against the reference. The reference's own metrics are measured by passing it in as both */
+	static FMetrics Measure(const FScenario& Scenario, const TArray<FSample>& Samples, const TArray<FSample>& Reference)
+	{
+		FMetrics Metrics;
+		const FVector Start = GetValueAtTime(Reference, Scenario.StepTime);
+		const FVector Final = Reference.Last().Value;
+		const float Travel = FMath::Max((Final - Start).Size(), UE_KINDA_SMALL_NUMBER);
+		const FVector Direction = (Final - Start) / Travel;
+		const float SettleTolerance = Travel * 0.02f;
+
+		FVector PreviousVelocity = FVector::ZeroVector;
+		FVector PreviousAcceleration = FVector::ZeroVector;
+		double JerkSquaredSum = 0.0;
+		int32 NumJerkSamples = 0;
+
+		for (int32 Index = 1; Index < Samples.Num(); ++Index)
+		{
+			const FSample& Sample = Samples[Index];
+			const float DeltaTime = FMath::Max(Sample.Time - Samples[Index - 1].Time, UE_SMALL_NUMBER);
+
+			Metrics.Divergence = FMath::Max(Metrics.Divergence, (Sample.Value - GetValueAtTime(Reference, Sample.Time)).Size() / Travel * 100.0f);
+
+			if (Sample.Time >= Scenario.StepTime)
+			{
+				const float Progress = FVector::DotProduct(Sample.Value - Start, Direction);
+				Metrics.Overshoot = FMath::Max(Metrics.Overshoot, (Progress - Travel) / Travel * 100.0f);
+				if ((Sample.Value - Final).Size() > SettleTolerance) Metrics.SettleTime = Sample.Time - Scenario.StepTime;
+			}
+
+			// The jerk is the third finite difference, which needs three previous samples
+			const FVector Velocity = (Sample.Value - Samples[Index - 1].Value) / DeltaTime;
+			const FVector Acceleration = (Velocity - PreviousVelocity) / DeltaTime;
+			if (Index >= 3)
+			{
+				JerkSquaredSum += ((Acceleration - PreviousAcceleration) / DeltaTime).SizeSquared() / FMath::Square(Travel);
+				++NumJerkSamples;
+			}
+
+			PreviousVelocity = Velocity;
+			PreviousAcceleration = Acceleration;
+		}
+
+		Metrics.Jerk = NumJerkSamples > 0 ? FMath::Sqrt(JerkSquaredSum / NumJerkSamples) : 0.0f;
+		return Metrics;
+	}
+}
+
+
+/**
+ * Replays recorded input and target tracks through a camera character and camera manager in a game world at different frame rates, and compares the manager's view against a 240hz reference. \n\n
+ *
+ * Each scenario drives the character's location, control rotation, camera style, orientation and target lock, and the world is ticked so the character, it's camera arm and the camera manager
+ * all update the way they do in game. Every frame rate is measured for jerk, overshoot, settle time and divergence from the reference, and fails if it's over the Camera.Smoothness.* thresholds
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCameraSmoothnessTest, "CharacterCameraSystem.Smoothness.FrameRates", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FCameraSmoothnessTest::RunTest(const FString& Parameters)
+{
+	using namespace CameraSmoothness;
+
+	const float MaxDivergence = CVarCameraSmoothnessMaxDivergence.GetValueOnGameThread();
+	const float MaxOvershoot = CVarCameraSmoothnessMaxOvershoot.GetValueOnGameThread();
+	const float MaxSettleTimeDelta = CVarCameraSmoothnessMaxSettleTimeDelta.GetValueOnGameThread();
+	const float MaxJerkRatio = CVarCameraSmoothnessMaxJerkRatio.GetValueOnGameThread();
+
+	TArray<FSample> Reference;
+	TArray<FSample> Samples;
+	for (const FScenario& Scenario : MakeScenarios())
+	{
+		Simulate(Scenario, ReferenceFrameRate, Reference);
+		const FMetrics ReferenceMetrics = Measure(Scenario, Reference, Reference);
+		AddInfo(FString::Printf(TEXT("%s (%s): overshoot %.2f%%, settle %.3fs, jerk %.2f"),
+			Scenario.Name, ReferenceFrameRate.Name, ReferenceMetrics.Overshoot, ReferenceMetrics.SettleTime, ReferenceMetrics.Jerk
+		));
+
+		for (const FFrameRate& FrameRate : FrameRates)
+		{
+			Simulate(Scenario, FrameRate, Samples);
+			const FMetrics Metrics = Measure(Scenario, Samples, Reference);
+			const float JerkRatio = ReferenceMetrics.Jerk > UE_KINDA_SMALL_NUMBER ? Metrics.Jerk / ReferenceMetrics.Jerk : 0.0f;
+
+			TArray<FString> Failures;
+			if (Metrics.Divergence > MaxDivergence) Failures.Add(TEXT("divergence"));
+			if (Metrics.Overshoot > ReferenceMetrics.Overshoot + MaxOvershoot) Failures.Add(TEXT("overshoot"));
+			if (FMath::Abs(Metrics.SettleTime - ReferenceMetrics.SettleTime) > MaxSettleTimeDelta) Failures.Add(TEXT("settle time"));
+			if (JerkRatio > MaxJerkRatio) Failures.Add(TEXT("jerk"));
+
+			const FString Result = FString::Printf(TEXT("%s %s: divergence %.2f%%, overshoot %.2f%%, settle %.3fs, jerk %.2fx"),
+				Scenario.Name, FrameRate.Name, Metrics.Divergence, Metrics.Overshoot, Metrics.SettleTime, JerkRatio
+			);
+
+			if (Failures.IsEmpty()) AddInfo(Result);
+			else AddError(FString::Printf(TEXT("%s (%s)"), *Result, *FString::Join(Failures, TEXT(", "))));
+		}
+	}
+
+	return true;
+}
+
+#endif
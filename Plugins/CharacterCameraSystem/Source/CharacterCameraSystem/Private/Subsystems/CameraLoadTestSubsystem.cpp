@@ -0,0 +1,111 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Subsystems/CameraLoadTestSubsystem.h"
+
+#include "Character/CharacterCameraLogic.h"
+#include "Debug/CameraBotComponent.h"
+#include "Debug/CameraNetProfiler.h"
+#include "GameFramework/GameModeBase.h"
+#include "GameFramework/PlayerController.h"
+#include "Logging/StructuredLog.h"
+#include "TimerManager.h"
+
+
+bool UCameraLoadTestSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+#if UE_BUILD_SHIPPING
+	return false;
+#else
+	if (!Super::ShouldCreateSubsystem(Outer)) return false;
+	return FParse::Param(FCommandLine::Get(), TEXT("CameraBots")) || FCString::Strifind(FCommandLine::Get(), TEXT("CameraBotTargets=")) != nullptr;
+#endif
+}
+
+
+void UCameraLoadTestSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	int32 NumTargets = 0;
+	if (InWorld.GetNetMode() != NM_Client && FParse::Value(FCommandLine::Get(), TEXT("CameraBotTargets="), NumTargets) && NumTargets > 0)
+	{
+		SpawnTargets(NumTargets);
+	}
+
+	if (InWorld.GetNetMode() != NM_DedicatedServer && FParse::Param(FCommandLine::Get(), TEXT("CameraBots")))
+	{
+		InWorld.GetTimerManager().SetTimer(BotTimer, this, &UCameraLoadTestSubsystem::AddBots, 1.0f, true);
+	}
+
+	FCameraNetProfiler::Reset();
+}
+
+
+void UCameraLoadTestSubsystem::Deinitialize()
+{
+	if (const UWorld* World = GetWorld())
+	{
+		World->GetTimerManager().ClearTimer(BotTimer);
+	}
+
+	FCameraNetProfiler::Dump(64);
+	Targets.Empty();
+	Super::Deinitialize();
+}
+
+
+void UCameraLoadTestSubsystem::SpawnTargets(const int32 NumTargets)
+{
+	UWorld* World = GetWorld();
+
+	// Use the game's character if it's a camera character, so the targets have a mesh and movement
+	TSubclassOf<ACharacterCameraLogic> TargetClass = ACharacterCameraLogic::StaticClass();
+	const AGameModeBase* GameMode = World->GetAuthGameMode();
+	if (GameMode && GameMode->DefaultPawnClass && GameMode->DefaultPawnClass->IsChildOf(ACharacterCameraLogic::StaticClass()))
+	{
+		TargetClass = *GameMode->DefaultPawnClass;
+	}
+
+	float Radius = 1500.0f;
+	FParse::Value(FCommandLine::Get(), TEXT("CameraBotTargetRadius="), Radius);
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+	for (int32 Index = 0; Index < NumTargets; ++Index)
+	{
+		const float Angle = UE_TWO_PI * Index / NumTargets;
+		const FVector Location(FMath::Cos(Angle) * Radius, FMath::Sin(Angle) * Radius, 100.0f);
+		ACharacterCameraLogic* Target = World->SpawnActor<ACharacterCameraLogic>(TargetClass, Location, FRotator(0.0f, FMath::RadiansToDegrees(Angle) + 180.0f, 0.0f), SpawnParameters);
+		if (Target)
+		{
+			Target->SpawnDefaultController();
+			Targets.Add(Target);
+		}
+	}
+
+	UE_LOGFMT(CameraLog, Display, "Camera load test: spawned {0} {1} targets", Targets.Num(), *GetNameSafe(TargetClass));
+}
+
+
+void UCameraLoadTestSubsystem::AddBots()
+{
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+		if (!PlayerController || !PlayerController->IsLocalController()) continue;
+
+		ACharacterCameraLogic* Character = Cast<ACharacterCameraLogic>(PlayerController->GetPawn());
+		if (!Character || Character->FindComponentByClass<UCameraBotComponent>()) continue;
+
+		UCameraBotComponent* Bot = NewObject<UCameraBotComponent>(Character, TEXT("CameraBot"));
+		Bot->RegisterComponent();
+		UE_LOGFMT(CameraLog, Display, "Camera load test: added a camera bot to {0}", *Character->GetName());
+	}
+}
+
+
+bool UCameraLoadTestSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game;
+}
@@ -0,0 +1,27 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Subsystems/CameraRigSnapshotSubsystem.h"
+
+
+void UCameraRigSnapshotSubsystem::StoreSnapshot(const int32 ControllerId, const FCameraRigSnapshot& Snapshot)
+{
+	if (!Snapshot.bValid) return;
+	Snapshots.Add(ControllerId, Snapshot);
+}
+
+
+bool UCameraRigSnapshotSubsystem::FindSnapshot(const int32 ControllerId, FCameraRigSnapshot& OutSnapshot) const
+{
+	const FCameraRigSnapshot* Snapshot = Snapshots.Find(ControllerId);
+	if (!Snapshot) return false;
+
+	OutSnapshot = *Snapshot;
+	return true;
+}
+
+
+void UCameraRigSnapshotSubsystem::ClearSnapshot(const int32 ControllerId)
+{
+	Snapshots.Remove(ControllerId);
+}
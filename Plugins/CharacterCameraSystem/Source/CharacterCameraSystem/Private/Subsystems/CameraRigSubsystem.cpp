@@ -0,0 +1,171 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Subsystems/CameraRigSubsystem.h"
+
+#include "Async/ParallelFor.h"
+#include "Data/CameraClearanceField.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+
+DECLARE_CYCLE_STAT(TEXT("Camera Rig Batch"), STAT_CameraRigBatch, STATGROUP_CharacterCamera);
+DECLARE_CYCLE_STAT(TEXT("Camera Rig Batch Gather"), STAT_CameraRigBatchGather, STATGROUP_CharacterCamera);
+DECLARE_CYCLE_STAT(TEXT("Camera Rig Batch Solve"), STAT_CameraRigBatchSolve, STATGROUP_CharacterCamera);
+DECLARE_CYCLE_STAT(TEXT("Camera Rig Batch Commit"), STAT_CameraRigBatchCommit, STATGROUP_CharacterCamera);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Batched Camera Rigs"), STAT_CameraRigBatchNum, STATGROUP_CharacterCamera);
+
+static TAutoConsoleVariable<int32> CVarCameraRigParallelThreshold(
+	TEXT("Camera.Rig.ParallelThreshold"),
+	4,
+	TEXT("The number of batched camera rigs required before the rig math is solved in parallel. Below this it's solved on the game thread"),
+	ECVF_Default
+);
+
+
+void UCameraRigSubsystem::Tick(const float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_CameraRigBatch);
+	CSV_SCOPED_TIMING_STAT(CharacterCamera, RigBatch);
+
+	// Gather
+	{
+		SCOPE_CYCLE_COUNTER(STAT_CameraRigBatchGather);
+		ActiveRigs.Reset();
+		for (UTargetLockSpringArm* Rig : Rigs)
+		{
+			if (!IsValid(Rig) || !Rig->IsRegistered() || !Rig->IsActive()) continue;
+			ActiveRigs.Add(Rig);
+		}
+
+		const int32 NumRigs = ActiveRigs.Num();
+		RigSettings.SetNum(NumRigs, false);
+		RigInputs.SetNum(NumRigs, false);
+		RigStates.SetNum(NumRigs, false);
+		RigOutputs.SetNum(NumRigs, false);
+		SocketBlends.SetNum(NumRigs, false);
+
+		for (int32 Index = 0; Index < NumRigs; ++Index)
+		{
+			UTargetLockSpringArm* Rig = ActiveRigs[Index];
+			const AActor* Owner = Rig->GetOwner();
+			const float RigDeltaTime = Owner ? DeltaTime * Owner->CustomTimeDilation : DeltaTime;
+
+			Rig->GatherSocketBlend(RigDeltaTime, SocketBlends[Index]);
+			Rig->GatherRig(Rig->bDoCollisionTest, Rig->bEnableCameraLag, Rig->bEnableCameraRotationLag, RigDeltaTime, RigSettings[Index], RigInputs[Index], RigStates[Index]);
+		}
+	}
+
+	SET_DWORD_STAT(STAT_CameraRigBatchNum, ActiveRigs.Num());
+	CSV_CUSTOM_STAT(CharacterCamera, BatchedRigs, ActiveRigs.Num(), ECsvCustomStatOp::Set);
+	if (ActiveRigs.IsEmpty()) return;
+
+	// Solve
+	{
+		SCOPE_CYCLE_COUNTER(STAT_CameraRigBatchSolve);
+		const int32 NumRigs = ActiveRigs.Num();
+		const bool bSingleThreaded = NumRigs < CVarCameraRigParallelThreshold.GetValueOnGameThread();
+		ParallelFor(NumRigs, [this](const int32 Index)
+		{
+			// The socket transition adjusts the offsets the rig math is based on
+			FCameraRigSocketBlend& Blend = SocketBlends[Index];
+			if (Blend.bActive)
+			{
+				Blend.Solve();
+				RigSettings[Index].SocketOffset = Blend.SocketOffset;
+				RigSettings[Index].TargetArmLength = Blend.TargetArmLength;
+				RigSettings[Index].CameraLagSpeed = Blend.CameraLagSpeed;
+				RigInputs[Index].TargetOffset = Blend.TargetOffset;
+				RigInputs[Index].bDoLocationLag = Blend.bEnableCameraLag;
+			}
+
+			UTargetLockSpringArm::SolveRig(RigSettings[Index], RigInputs[Index], RigStates[Index], RigOutputs[Index]);
+		}, bSingleThreaded ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+	}
+
+	// Commit
+	{
+		SCOPE_CYCLE_COUNTER(STAT_CameraRigBatchCommit);
+		for (int32 Index = 0; Index < ActiveRigs.Num(); ++Index)
+		{
+			UTargetLockSpringArm* Rig = ActiveRigs[Index];
+			Rig->CommitSocketBlend(SocketBlends[Index]);
+			Rig->CommitRig(RigInputs[Index], RigStates[Index], RigOutputs[Index]);
+		}
+	}
+}
+
+
+void UCameraRigSubsystem::RegisterRig(UTargetLockSpringArm* Rig)
+{
+	if (!Rig) return;
+	Rigs.AddUnique(Rig);
+}
+
+
+void UCameraRigSubsystem::UnregisterRig(UTargetLockSpringArm* Rig)
+{
+	Rigs.RemoveSwap(Rig);
+}
+
+
+int32 UCameraRigSubsystem::GetNumRigs() const
+{
+	return Rigs.Num();
+}
+
+
+void UCameraRigSubsystem::SetClearanceField(UCameraClearanceField* Field, ULevel* Level)
+{
+	if (!Level) Level = GetWorld()->PersistentLevel;
+	if (Field) ClearanceFields.Add(Level, Field);
+	else ClearanceFields.Remove(Level);
+}
+
+
+UCameraClearanceField* UCameraRigSubsystem::GetClearanceField(const FVector& Location) const
+{
+	for (const TPair<TObjectPtr<ULevel>, TObjectPtr<UCameraClearanceField>>& ClearanceField : ClearanceFields)
+	{
+		if (ClearanceField.Value && ClearanceField.Value->IsBaked() && ClearanceField.Value->Contains(Location)) return ClearanceField.Value;
+	}
+	return nullptr;
+}
+
+
+void UCameraRigSubsystem::OnLevelRemovedFromWorld(ULevel* Level, UWorld* World)
+{
+	if (World != GetWorld()) return;
+
+	// A null level means every level is being removed
+	if (Level) ClearanceFields.Remove(Level);
+	else ClearanceFields.Reset();
+}
+
+
+void UCameraRigSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	LevelRemovedHandle = FWorldDelegates::LevelRemovedFromWorld.AddUObject(this, &UCameraRigSubsystem::OnLevelRemovedFromWorld);
+}
+
+
+void UCameraRigSubsystem::Deinitialize()
+{
+	FWorldDelegates::LevelRemovedFromWorld.Remove(LevelRemovedHandle);
+	Rigs.Empty();
+	ClearanceFields.Empty();
+	ActiveRigs.Empty();
+	Super::Deinitialize();
+}
+
+
+TStatId UCameraRigSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCameraRigSubsystem, STATGROUP_Tickables);
+}
+
+
+bool UCameraRigSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
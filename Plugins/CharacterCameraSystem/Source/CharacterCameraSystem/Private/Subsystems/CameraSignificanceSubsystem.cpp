@@ -0,0 +1,281 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Subsystems/CameraSignificanceSubsystem.h"
+
+#include "SignificanceManager.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Character/CharacterCameraLogic.h"
+#include "Components/SkeletalMeshComponent.h"
+
+DECLARE_CYCLE_STAT(TEXT("Camera Significance"), STAT_CameraSignificance, STATGROUP_CharacterCamera);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Camera Significance Views"), STAT_CameraSignificanceViews, STATGROUP_CharacterCamera);
+
+static TAutoConsoleVariable<bool> CVarCameraSignificanceEnabled(
+	TEXT("Camera.Significance.Enabled"),
+	true,
+	TEXT("Updates the significance manager from the local players' cameras"),
+	ECVF_Default
+);
+
+const FName UCameraSignificanceSubsystem::SignificanceTag = FName("CameraSignificance");
+
+/** The significance of the local players' current targets, above every bucket */
+static constexpr float PinnedSignificance = 2.0f;
+
+
+UCameraSignificanceSubsystem::UCameraSignificanceSubsystem()
+{
+	MaxSignificanceDistance = 10000.0;
+	OffScreenSignificanceScale = 0.5;
+	OccludedSignificanceScale = 0.5;
+	OcclusionGracePeriod = 0.2;
+
+	Buckets.Add(FCameraSignificanceBucket(0.75, 0.0));
+	Buckets.Add(FCameraSignificanceBucket(0.4, 0.1));
+	Buckets.Add(FCameraSignificanceBucket(0.15, 0.25));
+	Buckets.Add(FCameraSignificanceBucket(0.0, 0.5));
+}
+
+
+void UCameraSignificanceSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	Buckets.Sort([](const FCameraSignificanceBucket& A, const FCameraSignificanceBucket& B) { return A.MinSignificance > B.MinSignificance; });
+}
+
+
+void UCameraSignificanceSubsystem::Deinitialize()
+{
+	if (USignificanceManager* SignificanceManager = GetSignificanceManager())
+	{
+		SignificanceManager->UnregisterAll(SignificanceTag);
+	}
+
+	Views.Empty();
+	PinnedActors.Empty();
+	OriginalTickIntervals.Empty();
+	Super::Deinitialize();
+}
+
+
+void UCameraSignificanceSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_CameraSignificance);
+	if (!CVarCameraSignificanceEnabled.GetValueOnGameThread()) return;
+
+	USignificanceManager* SignificanceManager = GetSignificanceManager();
+	if (!SignificanceManager) return;
+
+	GatherViews();
+	SET_DWORD_STAT(STAT_CameraSignificanceViews, Views.Num());
+
+	// Without any views everything would be the lowest significance, so keep the previous results
+	if (Views.IsEmpty()) return;
+	SignificanceManager->Update(ViewTransforms);
+}
+
+
+void UCameraSignificanceSubsystem::GatherViews()
+{
+	Views.Reset();
+	PinnedActors.Reset();
+	ViewTransforms.Reset();
+
+	for (FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator)
+	{
+		const APlayerController* PlayerController = Iterator->Get();
+		if (!PlayerController || !PlayerController->IsLocalController() || !PlayerController->PlayerCameraManager) continue;
+
+		const APlayerCameraManager* CameraManager = PlayerController->PlayerCameraManager;
+		if (CameraManager->GetCameraCacheTime() <= 0.0f) continue;
+
+		// Use the diagonal of the view so actors in the corners of the screen are within the view
+		const FMinimalViewInfo& POV = CameraManager->GetCameraCacheView();
+		const float AspectRatio = FMath::Max(POV.AspectRatio, UE_KINDA_SMALL_NUMBER);
+		const float TanHalfFOV = FMath::Tan(FMath::DegreesToRadians(FMath::Clamp(POV.FOV, 1.0f, 170.0f) * 0.5f));
+
+		FCameraSignificanceView& View = Views.AddDefaulted_GetRef();
+		View.Location = POV.Location;
+		View.Direction = POV.Rotation.Vector();
+		View.HalfFOV = FMath::Atan(TanHalfFOV * FMath::Sqrt(1.0f + 1.0f / FMath::Square(AspectRatio)));
+		ViewTransforms.Add(FTransform(POV.Rotation, POV.Location));
+
+		if (const ACharacterCameraLogic* Character = Cast<ACharacterCameraLogic>(CameraManager->GetViewTarget()))
+		{
+			if (const AActor* CurrentTarget = Character->GetCurrentTarget())
+			{
+				PinnedActors.AddUnique(CurrentTarget);
+			}
+		}
+	}
+}
+
+
+float UCameraSignificanceSubsystem::CalculateSignificance(const AActor* Actor, const FTransform& ViewTransform) const
+{
+	if (!Actor) return 0.0f;
+	if (PinnedActors.Contains(Actor)) return PinnedSignificance;
+
+	// The significance manager only passes the view's transform, so find the rest of the view from it's location
+	const FVector ViewLocation = ViewTransform.GetLocation();
+	const FCameraSignificanceView* View = Views.FindByPredicate([&ViewLocation](const FCameraSignificanceView& Other) { return Other.Location == ViewLocation; });
+	if (!View) return 0.0f;
+
+	const USceneComponent* Root = Actor->GetRootComponent();
+	const float Radius = Root ? Root->Bounds.SphereRadius : 0.0f;
+	const FVector ToActor = Actor->GetActorLocation() - View->Location;
+	const float Distance = ToActor.Size();
+	if (Distance <= Radius) return 1.0f;
+
+	float Significance = 1.0f - FMath::Clamp((Distance - Radius) / FMath::Max(MaxSignificanceDistance, 1.0f), 0.0f, 1.0f);
+
+	// The bounds are within the view if the angle to the actor, minus the angle the bounds cover, is within the view's half fov
+	const float Angle = FMath::Acos(FMath::Clamp(FVector::DotProduct(ToActor / Distance, View->Direction), -1.0f, 1.0f));
+	const float BoundsAngle = FMath::Asin(FMath::Min(Radius / Distance, 1.0f));
+	if (Angle - BoundsAngle > View->HalfFOV)
+	{
+		Significance *= OffScreenSignificanceScale;
+	}
+	else if (!Actor->WasRecentlyRendered(OcclusionGracePeriod))
+	{
+		Significance *= OccludedSignificanceScale;
+	}
+
+	return Significance;
+}
+
+
+void UCameraSignificanceSubsystem::RegisterActor(AActor* Actor)
+{
+	USignificanceManager* SignificanceManager = GetSignificanceManager();
+	if (!IsValid(Actor) || !SignificanceManager) return;
+	if (SignificanceManager->GetManagedObject(Actor)) return;
+
+	FCameraSignificanceTickIntervals& TickIntervals = OriginalTickIntervals.Add(Actor);
+	TickIntervals.ActorTickInterval = Actor->GetActorTickInterval();
+	TInlineComponentArray<USkeletalMeshComponent*> Meshes(Actor);
+	for (USkeletalMeshComponent* Mesh : Meshes)
+	{
+		TickIntervals.MeshTickIntervals.Emplace(Mesh, Mesh->GetComponentTickInterval());
+	}
+
+	SignificanceManager->RegisterObject(
+		Actor,
+		SignificanceTag,
+		[this](USignificanceManager::FManagedObjectInfo* ObjectInfo, const FTransform& ViewTransform)
+		{
+			return CalculateSignificance(Cast<AActor>(ObjectInfo->GetObject()), ViewTransform);
+		},
+		USignificanceManager::EPostSignificanceType::Sequential,
+		[this](USignificanceManager::FManagedObjectInfo* ObjectInfo, const float OldSignificance, const float Significance, const bool bFinal)
+		{
+			AActor* Actor = Cast<AActor>(ObjectInfo->GetObject());
+			if (bFinal)
+			{
+				RestoreTickIntervals(Actor);
+				return;
+			}
+
+			const int32 Bucket = GetSignificanceBucket(Significance);
+			if (Bucket != GetSignificanceBucket(OldSignificance))
+			{
+				ApplySignificanceBucket(Actor, Bucket);
+			}
+		}
+	);
+
+	ApplySignificanceBucket(Actor, GetSignificanceBucket(SignificanceManager->GetSignificance(Actor)));
+	Actor->OnEndPlay.AddUniqueDynamic(this, &UCameraSignificanceSubsystem::OnRegisteredActorEndPlay);
+}
+
+
+void UCameraSignificanceSubsystem::UnregisterActor(AActor* Actor)
+{
+	if (!Actor) return;
+	Actor->OnEndPlay.RemoveDynamic(this, &UCameraSignificanceSubsystem::OnRegisteredActorEndPlay);
+
+	USignificanceManager* SignificanceManager = GetSignificanceManager();
+	if (SignificanceManager && SignificanceManager->GetManagedObject(Actor))
+	{
+		SignificanceManager->UnregisterObject(Actor);
+	}
+
+	// The significance manager restores them when the actor is unregistered, this covers actors it no longer has
+	RestoreTickIntervals(Actor);
+}
+
+
+void UCameraSignificanceSubsystem::OnRegisteredActorEndPlay(AActor* Actor, EEndPlayReason::Type EndPlayReason)
+{
+	UnregisterActor(Actor);
+}
+
+
+void UCameraSignificanceSubsystem::ApplySignificanceBucket(AActor* Actor, const int32 Bucket) const
+{
+	if (!IsValid(Actor) || !Buckets.IsValidIndex(Bucket)) return;
+
+	const float TickInterval = Buckets[Bucket].TickInterval;
+	Actor->SetActorTickInterval(TickInterval);
+
+	TInlineComponentArray<USkeletalMeshComponent*> Meshes(Actor);
+	for (USkeletalMeshComponent* Mesh : Meshes)
+	{
+		Mesh->SetComponentTickInterval(TickInterval);
+	}
+}
+
+
+void UCameraSignificanceSubsystem::RestoreTickIntervals(AActor* Actor)
+{
+	FCameraSignificanceTickIntervals TickIntervals;
+	if (!Actor || !OriginalTickIntervals.RemoveAndCopyValue(Actor, TickIntervals)) return;
+
+	Actor->SetActorTickInterval(TickIntervals.ActorTickInterval);
+	for (const TPair<TWeakObjectPtr<USkeletalMeshComponent>, float>& MeshTickInterval : TickIntervals.MeshTickIntervals)
+	{
+		if (USkeletalMeshComponent* Mesh = MeshTickInterval.Key.Get())
+		{
+			Mesh->SetComponentTickInterval(MeshTickInterval.Value);
+		}
+	}
+}
+
+
+int32 UCameraSignificanceSubsystem::GetActorSignificanceBucket(const AActor* Actor) const
+{
+	const USignificanceManager* SignificanceManager = GetSignificanceManager();
+	if (!Actor || !SignificanceManager) return INDEX_NONE;
+	return GetSignificanceBucket(SignificanceManager->GetSignificance(Actor));
+}
+
+
+int32 UCameraSignificanceSubsystem::GetSignificanceBucket(const float Significance) const
+{
+	for (int32 Index = 0; Index < Buckets.Num(); ++Index)
+	{
+		if (Significance >= Buckets[Index].MinSignificance) return Index;
+	}
+
+	return Buckets.Num() - 1;
+}
+
+
+USignificanceManager* UCameraSignificanceSubsystem::GetSignificanceManager() const
+{
+	return USignificanceManager::Get(GetWorld());
+}
+
+
+TStatId UCameraSignificanceSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCameraSignificanceSubsystem, STATGROUP_Tickables);
+}
+
+
+bool UCameraSignificanceSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
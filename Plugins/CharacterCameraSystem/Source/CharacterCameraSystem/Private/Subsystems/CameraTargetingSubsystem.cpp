@@ -0,0 +1,283 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Subsystems/CameraTargetingSubsystem.h"
+
+#include "Async/ParallelFor.h"
+#include "Character/CharacterCameraLogic.h"
+
+DECLARE_CYCLE_STAT(TEXT("Batched Target Selection"), STAT_CameraBatchTargetSelection, STATGROUP_CharacterCamera);
+DECLARE_CYCLE_STAT(TEXT("Batched Target Selection Scoring"), STAT_CameraBatchTargetScoring, STATGROUP_CharacterCamera);
+DECLARE_CYCLE_STAT(TEXT("Target Re-evaluation"), STAT_CameraTargetReevaluation, STATGROUP_CharacterCamera);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Target Re-evaluation Scores"), STAT_CameraTargetReevaluationScores, STATGROUP_CharacterCamera);
+
+static TAutoConsoleVariable<float> CVarTargetReevaluationBudget(
+	TEXT("Camera.TargetReevaluation.BudgetMicroseconds"),
+	50.0f,
+	TEXT("The time budget for the background target re-evaluation each frame, in microseconds. At least one target is always scored"),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<int32> CVarTargetReevaluationMaxScores(
+	TEXT("Camera.TargetReevaluation.MaxScoresPerFrame"),
+	16,
+	TEXT("The maximum number of targets the background target re-evaluation scores each frame"),
+	ECVF_Default
+);
+
+
+/** Per task scratch data for the batched target selection */
+struct FCameraTargetSelectionContext
+{
+	TArray<FTargetLockInformation> TargetLockData;
+};
+
+
+int32 UCameraTargetingSubsystem::BatchAdjustCurrentTargets(const TArray<FCameraTargetRequest>& Requests)
+{
+	SCOPE_CYCLE_COUNTER(STAT_CameraBatchTargetSelection);
+
+	BatchCharacters.Reset();
+	BatchCandidateStart.Reset();
+	BatchCandidateNum.Reset();
+	BatchPlayerLocations.Reset();
+	BatchAimRotations.Reset();
+	BatchPreviousTargets.Reset();
+	BatchCandidates.Reset();
+	BatchCandidateLocations.Reset();
+
+	// Gather the character and target information on the game thread
+	TArray<EPreviousTargetLockOrientation, TInlineAllocator<64>> Directions;
+	for (const FCameraTargetRequest& Request : Requests)
+	{
+		ACharacterCameraLogic* Character = Request.Character;
+		if (!IsValid(Character)) continue;
+
+		// The candidates replace the character's targets instead of being merged with them, so targets the character no longer knows about aren't kept around
+		TArray<AActor*>& Targets = Character->GetTargetLockCharactersReference();
+		if (!Request.Candidates.IsEmpty())
+		{
+			Targets.Reset(Request.Candidates.Num());
+			for (AActor* Candidate : Request.Candidates)
+			{
+				if (IsValid(Candidate)) Targets.AddUnique(Candidate);
+			}
+		}
+
+		BatchCharacters.Add(Character);
+		BatchCandidateStart.Add(BatchCandidates.Num());
+		BatchCandidateNum.Add(Targets.Num());
+		BatchPlayerLocations.Add(Character->GetActorLocation());
+		BatchAimRotations.Add(Character->GetBaseAimRotation());
+		BatchPreviousTargets.Add(Character->GetCurrentTarget());
+		Directions.Add(Request.NextTargetDirection);
+
+		for (AActor* Target : Targets)
+		{
+			BatchCandidates.Add(Target);
+			BatchCandidateLocations.Add(Targets.Num() > 1 ? Target->GetActorLocation() : FVector::ZeroVector);
+		}
+	}
+
+	const int32 NumRequests = BatchCharacters.Num();
+	BatchResults.SetNum(NumRequests, false);
+	BatchSelectedTargets.SetNum(NumRequests, false);
+
+	// Score each of the requests
+	{
+		SCOPE_CYCLE_COUNTER(STAT_CameraBatchTargetScoring);
+		TArray<FCameraTargetSelectionContext> Contexts;
+		ParallelForWithTaskContext(Contexts, NumRequests, [this, &Directions](FCameraTargetSelectionContext& Context, const int32 Index)
+		{
+			const TArrayView<AActor* const> Targets = MakeArrayView(BatchCandidates.GetData() + BatchCandidateStart[Index], BatchCandidateNum[Index]);
+			const TArrayView<const FVector> TargetLocations = MakeArrayView(BatchCandidateLocations.GetData() + BatchCandidateStart[Index], BatchCandidateNum[Index]);
+
+			FTargetLockInformation NextTarget;
+			BatchResults[Index] = ACharacterCameraLogic::SelectNextTarget(
+				BatchPlayerLocations[Index],
+				BatchAimRotations[Index],
+				BatchCharacters[Index],
+				BatchPreviousTargets[Index],
+				Targets,
+				TargetLocations,
+				Directions[Index],
+				Context.TargetLockData,
+				NextTarget
+			);
+			BatchSelectedTargets[Index] = NextTarget.Target;
+		});
+	}
+
+	// Apply the results on the game thread
+	int32 NumSelected = 0;
+	for (int32 Index = 0; Index < NumRequests; ++Index)
+	{
+		ACharacterCameraLogic* Character = BatchCharacters[Index];
+		if (BatchResults[Index] == ETargetSelectionResult::NoTargets)
+		{
+			Character->BreakTargetLock();
+		}
+		else if (BatchResults[Index] == ETargetSelectionResult::Selected)
+		{
+			Character->ApplyTargetSelection(BatchSelectedTargets[Index]);
+			NumSelected++;
+		}
+	}
+
+	return NumSelected;
+}
+
+
+void UCameraTargetingSubsystem::RegisterTargetReevaluation(ACharacterCameraLogic* Character)
+{
+	if (!Character) return;
+	for (const FTargetReevaluationState& State : ReevaluationStates)
+	{
+		if (State.Character == Character) return;
+	}
+
+	FTargetReevaluationState& State = ReevaluationStates.AddDefaulted_GetRef();
+	State.Character = Character;
+}
+
+
+void UCameraTargetingSubsystem::UnregisterTargetReevaluation(ACharacterCameraLogic* Character)
+{
+	for (int32 Index = 0; Index < ReevaluationStates.Num(); ++Index)
+	{
+		// Removing it here would shift the states that Tick is iterating over, invalid states are removed there instead
+		FTargetReevaluationState& State = ReevaluationStates[Index];
+		if (State.Character == Character)
+		{
+			State.Character.Reset();
+			State.CachedScores.Reset();
+			State.NextCandidate = 0;
+			return;
+		}
+	}
+}
+
+
+void UCameraTargetingSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_CameraTargetReevaluation);
+	CSV_SCOPED_TIMING_STAT(CharacterCamera, TargetReevaluation);
+	if (ReevaluationStates.IsEmpty()) return;
+
+	const uint64 BudgetCycles = static_cast<uint64>(CVarTargetReevaluationBudget.GetValueOnGameThread() / (FPlatformTime::GetSecondsPerCycle64() * 1000000.0));
+	const int32 MaxScores = FMath::Max(1, CVarTargetReevaluationMaxScores.GetValueOnGameThread());
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+
+	int32 NumScores = 0;
+	while (!ReevaluationStates.IsEmpty() && NumScores < MaxScores)
+	{
+		if (NextReevaluation >= ReevaluationStates.Num()) NextReevaluation = 0;
+		FTargetReevaluationState& State = ReevaluationStates[NextReevaluation];
+		if (!State.Character.IsValid())
+		{
+			ReevaluationStates.RemoveAtSwap(NextReevaluation);
+			continue;
+		}
+
+		// Round robin, one target per character at a time
+		ReevaluateNextCandidate(State);
+		NextReevaluation++;
+		NumScores++;
+
+		if (FPlatformTime::Cycles64() - StartCycles > BudgetCycles) break;
+	}
+
+	SET_DWORD_STAT(STAT_CameraTargetReevaluationScores, NumScores);
+}
+
+
+bool UCameraTargetingSubsystem::ReevaluateNextCandidate(FTargetReevaluationState& State)
+{
+	ACharacterCameraLogic* Character = State.Character.Get();
+	const TArray<AActor*>& Targets = Character->GetTargetLockCharactersReference();
+
+	// A target that's no longer valid is handled right away instead of waiting for the next pass
+	AActor* CurrentTarget = Character->GetCurrentTarget();
+	if (CurrentTarget && !Character->IsTargetValid(CurrentTarget))
+	{
+		State.CachedScores.Reset();
+		State.NextCandidate = 0;
+		for (AActor* Target : Targets)
+		{
+			State.CachedScores.Emplace(Target, Target == CurrentTarget ? MAX_FLT : Character->ScoreTarget(Target));
+		}
+
+		ResolveTargetReevaluation(State);
+		return true;
+	}
+
+	if (State.NextCandidate >= Targets.Num())
+	{
+		// The targets can shrink during a pass, scores past the end are for characters that aren't candidates anymore
+		State.CachedScores.SetNum(Targets.Num());
+
+		// Resolving can break the target lock, which unregisters the character, so the state isn't used afterwards
+		State.NextCandidate = 0;
+		ResolveTargetReevaluation(State);
+		return true;
+	}
+
+	// Each pass starts with no scores, so nothing from the last pass is resolved again
+	if (State.NextCandidate == 0) State.CachedScores.Reset(Targets.Num());
+	if (State.CachedScores.Num() != Targets.Num()) State.CachedScores.SetNum(Targets.Num());
+	AActor* Target = Targets[State.NextCandidate];
+	State.CachedScores[State.NextCandidate] = TPair<TWeakObjectPtr<AActor>, float>(Target, Character->ScoreTarget(Target));
+	State.NextCandidate++;
+	return false;
+}
+
+
+void UCameraTargetingSubsystem::ResolveTargetReevaluation(FTargetReevaluationState& State)
+{
+	ACharacterCameraLogic* Character = State.Character.Get();
+	AActor* CurrentTarget = Character->GetCurrentTarget();
+
+	AActor* BestTarget = nullptr;
+	float BestScore = MAX_FLT;
+	float CurrentTargetScore = MAX_FLT;
+	for (const TPair<TWeakObjectPtr<AActor>, float>& CachedScore : State.CachedScores)
+	{
+		AActor* Target = CachedScore.Key.Get();
+		if (!Target) continue;
+
+		if (Target == CurrentTarget) CurrentTargetScore = CachedScore.Value;
+		if (CachedScore.Value < BestScore)
+		{
+			BestTarget = Target;
+			BestScore = CachedScore.Value;
+		}
+	}
+
+	if (CurrentTargetScore == MAX_FLT)
+	{
+		// The current target is invalid or out of range
+		if (BestTarget) Character->ApplyTargetSelection(BestTarget);
+		else Character->BreakTargetLock();
+	}
+	else if (BestTarget && BestTarget != CurrentTarget && BestScore + Character->GetTargetSwitchScoreMargin() < CurrentTargetScore)
+	{
+		Character->ApplyTargetSelection(BestTarget);
+	}
+}
+
+
+TStatId UCameraTargetingSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCameraTargetingSubsystem, STATGROUP_Tickables);
+}
+
+
+void UCameraTargetingSubsystem::Deinitialize()
+{
+	ReevaluationStates.Empty();
+	BatchCharacters.Empty();
+	BatchPreviousTargets.Empty();
+	BatchCandidates.Empty();
+	BatchSelectedTargets.Empty();
+	Super::Deinitialize();
+}
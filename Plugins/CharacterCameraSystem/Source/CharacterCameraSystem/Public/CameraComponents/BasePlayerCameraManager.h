@@ -4,7 +4,9 @@
 
 #include "CoreMinimal.h"
 #include "PlayerCameraTypes.h"
+#include "CameraComponents/CameraModifier_ProceduralShake.h"
 #include "Camera/PlayerCameraManager.h"
+#include "WorldPartition/WorldPartitionStreamingSource.h"
 #include "BasePlayerCameraManager.generated.h"
 
 // Camera logic
@@ -15,7 +17,10 @@
 // ->  Adjusting the pivot offset and the pov based on character controls? Give the character access to these perhaps?
 
 
+class ACameraRailActor;
 class ACharacterCameraLogic;
+class UCameraRigSnapshotSubsystem;
+class UDamageType;
 
 
 /**
@@ -39,24 +44,33 @@ class ACharacterCameraLogic;
  * @see https://docs.unrealengine.com/latest/INT/Gameplay/Framework/Camera/
  */
 UCLASS()
-class CHARACTERCAMERASYSTEM_API ABasePlayerCameraManager : public APlayerCameraManager
+class CHARACTERCAMERASYSTEM_API ABasePlayerCameraManager : public APlayerCameraManager, public IWorldPartitionStreamingSourceProvider
 {
 	GENERATED_BODY()
 	
 protected:
 	/**** Camera smoothing and transition values ****/
-	/** The pivot lag speed used for handling camera drag smoothing and transition speeds */
+	/**
+	 * Lags the camera behind the view target's pivot in the third person and target lock behaviors. This is cheaper than the spring arm's camera lag,
+	 * so cameras that only need pivot smoothing should disable the arm's lag and use this instead
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Player Camera Manager|Offsets") bool bEnablePivotLag;
+
+	/** The pivot lag speed used for handling camera drag smoothing and transition speeds, on each axis relative to the camera's yaw (forward, right, up) */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Player Camera Manager|Offsets") FVector PivotLagSpeed;
 
+	/** How far the pivot can lag behind on each axis relative to the camera's yaw before it's out of bounds. Zero doesn't bound the axis */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Player Camera Manager|Offsets") FVector PivotLagBounds;
+
 	/** The blend duration during crouch transitions */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Player Camera Manager") float CrouchBlendDuration;
 	/** The blend time of the current crouch transition */
 	UPROPERTY(BlueprintReadWrite, Category = "Player Camera Manager") float CrouchBlendTime;
 
-	/** The rotation lag speed */
+	/** The rotation lag speed of the pivot lag. Zero disables the rotation lag */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Player Camera Manager") float RotationLagSpeed;
 
-	/** The out of bounds lag speed */
+	/** The lag speed of the axes that are out of the PivotLagBounds, which pulls the pivot back within the bounds before it's clamped */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=  "Player Camera Manager") float OutOfBoundsLagSpeed;
 
 	/**** Camera values derived from the player on possess ****/
@@ -75,7 +89,208 @@ protected:
 	UPROPERTY(BlueprintReadWrite, Category = "Player Camera Manager|Update View Target") FVector CalculatedLocation;
 	UPROPERTY(BlueprintReadWrite, Category = "Player Camera Manager|Update View Target") FRotator CalculatedRotation;
 
-	
+	/** The view target the pivot lag is following, the lag is reset when this changes */
+	TWeakObjectPtr<AActor> PivotLagTarget;
+
+	/**** Camera transform synchronization ****/
+	/** How the final view is published at the end of UpdateViewTarget. The view target and camera cache always have the POV, this only controls how the camera manager actor follows it */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Player Camera Manager|Update View Target") ECameraTransformSync TransformSync;
+
+	/** Skips moving the camera manager entirely when nothing is attached to it that relies on it's transform */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Player Camera Manager|Update View Target") bool bSkipTransformSyncWithoutAttachments;
+
+	/**** Camera network priority ****/
+	/** Uses this player's camera view to adjust the network priority (and optionally the relevancy) of camera characters on the server */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Player Camera Manager|Networking") bool bUseCameraNetPriority;
+
+	/** The network priority scale for actors that are within the camera's view */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Player Camera Manager|Networking", meta=(ClampMin="0.0", UIMin = "1.0", UIMax = "4.0")) float InViewNetPriorityScale;
+
+	/** The network priority scale for actors that are behind the camera */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Player Camera Manager|Networking", meta=(ClampMin="0.0", UIMin = "0.0", UIMax = "1.0")) float BehindCameraNetPriorityScale;
+
+	/** Extra degrees added to the camera's field of view for what's considered within view, so actors near the edges of the screen aren't penalized */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Player Camera Manager|Networking", meta=(ClampMin="0.0", UIMin = "0.0", UIMax = "45.0")) float NetViewConeMargin;
+
+	/** Actors behind the camera that are further away than this aren't net relevant. Zero disables this */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Player Camera Manager|Networking", meta=(ClampMin="0.0", UIMin = "0.0")) float BehindCameraRelevancyDistance;
+
+	/** The field of view the owning client reported to the server, zero if it hasn't been reported */
+	UPROPERTY(BlueprintReadOnly, Transient, Category = "Player Camera Manager|Networking") float ReportedViewFOV;
+
+	/** Uses the view target's replicated view while spectating other players, instead of rebuilding their camera from the character's state. @see ACharacterCameraLogic::bReplicateSpectatorView */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Player Camera Manager|Networking") bool bUseSpectatorViews;
+
+	/**** Camera streaming ****/
+	/** Adds world partition streaming sources ahead of the camera's trajectory and at the destination of view target blends, so cells are loaded before the camera arrives. Only used for local players */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Player Camera Manager|Streaming") bool bUseCameraStreamingSource;
+
+	/** How far ahead the camera's trajectory is extrapolated, in seconds */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Player Camera Manager|Streaming", meta=(ClampMin="0.0", UIMin = "0.0", UIMax = "5.0")) float StreamingPredictionTime;
+
+	/** The furthest the predicted streaming source is placed from the camera */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Player Camera Manager|Streaming", meta=(ClampMin="0.0", UIMin = "0.0")) float MaxStreamingPredictionDistance;
+
+	/** How quickly the camera's tracked velocity follows it's actual velocity, which filters out jitter from the camera lag and shakes */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Player Camera Manager|Streaming", meta=(ClampMin="0.0", UIMin = "0.0", UIMax = "20.0")) float StreamingVelocityInterpSpeed;
+
+	/** The radius of the camera's streaming sources. Zero uses the loading range of the world partition grids */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Player Camera Manager|Streaming", meta=(ClampMin="0.0", UIMin = "0.0")) float StreamingSourceRadius;
+
+	/** The priority of the camera's streaming sources */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Player Camera Manager|Streaming") EStreamingSourcePriority StreamingSourcePriority;
+
+	/** The camera's velocity, smoothed by the StreamingVelocityInterpSpeed */
+	UPROPERTY(BlueprintReadOnly, Transient, Category = "Player Camera Manager|Streaming") FVector CameraVelocity;
+
+	/** The camera's location and view target during the previous update, used for tracking the camera's velocity */
+	FVector PreviousCameraLocation;
+	TWeakObjectPtr<AActor> PreviousStreamingViewTarget;
+
+	/** Locations that are streamed in ahead of time, and the time they expire */
+	TArray<TPair<FVector, double>> StreamingPrewarmLocations;
+
+	/** The names of the camera's streaming sources */
+	FName PredictedStreamingSourceName;
+	FName PendingViewTargetStreamingSourceName;
+	FName PrewarmStreamingSourceName;
+
+	/** True while the camera is registered with the world partition subsystem */
+	bool bStreamingSourceRegistered;
+
+	/**** Camera shakes ****/
+	/** The modifier that plays the procedural shakes, created with the first shake */
+	UPROPERTY(BlueprintReadOnly, Transient, Category = "Player Camera Manager|Shakes") TObjectPtr<UCameraModifier_ProceduralShake> ProceduralShakeModifier;
+
+	/**** Rail camera ****/
+	/** The rail the camera follows while the camera style is "Rail" */
+	UPROPERTY(BlueprintReadOnly, Transient, Category = "Player Camera Manager|Rail") TObjectPtr<ACameraRailActor> CameraRail;
+
+	/** The camera's distance along the rail */
+	UPROPERTY(BlueprintReadOnly, Transient, Category = "Player Camera Manager|Rail") float CameraRailDistance;
+
+	/** False until the camera has been placed on the rail, so it starts at the view target's projection instead of following it there */
+	bool bCameraRailDistanceValid;
+
+	/**** Group framing ****/
+	/** The shortest and longest distance of the camera from the group's center. Past the longest distance the field of view widens instead */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Player Camera Manager|Group Framing", meta=(ClampMin="0.0", UIMin = "0.0")) float GroupFramingMinArmLength;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Player Camera Manager|Group Framing", meta=(ClampMin="0.0", UIMin = "0.0")) float GroupFramingMaxArmLength;
+
+	/** The camera's pitch for a group of one, and for a group that's as large as the GroupFramingPitchRadius. Larger groups are viewed from higher up */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Player Camera Manager|Group Framing", meta=(UIMin = "-89.0", UIMax = "0.0")) float GroupFramingMinPitch;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Player Camera Manager|Group Framing", meta=(UIMin = "-89.0", UIMax = "0.0")) float GroupFramingMaxPitch;
+
+	/** The radius of the group at which the camera reaches the GroupFramingMaxPitch */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Player Camera Manager|Group Framing", meta=(ClampMin="1.0", UIMin = "100.0")) float GroupFramingPitchRadius;
+
+	/** The widest field of view the camera uses to keep the group on screen */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Player Camera Manager|Group Framing", meta=(ClampMin="1.0", ClampMax="170.0", UIMin = "60.0", UIMax = "130.0")) float GroupFramingMaxFOV;
+
+	/** The space around each member, added to the group's radius */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Player Camera Manager|Group Framing", meta=(ClampMin="0.0", UIMin = "0.0", UIMax = "500.0")) float GroupFramingPadding;
+
+	/** How quickly the camera follows the group's center, distance, pitch and field of view. Zero snaps to them */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Player Camera Manager|Group Framing", meta=(ClampMin="0.0", UIMin = "0.0", UIMax = "20.0")) float GroupFramingInterpSpeed;
+
+	/** How many members the group's bounds are rebuilt from each frame, which lets the bounds shrink once the group comes back together */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Player Camera Manager|Group Framing", meta=(ClampMin="1", UIMin = "1", UIMax = "32")) int32 GroupFramingRefinePerFrame;
+
+	/** The size and channel of the sweep that keeps the camera in front of anything between it and the group, for view targets without a spring arm. Otherwise the arm's probe is used */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Player Camera Manager|Group Framing", meta=(ClampMin="0.0", UIMin = "0.0", UIMax = "50.0")) float GroupFramingProbeSize;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Player Camera Manager|Group Framing") TEnumAsByte<ECollisionChannel> GroupFramingProbeChannel;
+
+	/** The actors of the group, the first is the view target and the rest are it's target lock characters. Each member's location is at the same index of the GroupBounds */
+	TArray<TWeakObjectPtr<AActor>> GroupMembers;
+	FCameraGroupBounds GroupBounds;
+
+	/** The camera's smoothed framing of the group */
+	FVector GroupFramingCenter;
+	float GroupFramingDistance;
+	float GroupFramingPitch;
+	float GroupFramingFOV;
+
+	/** False until the camera has framed the group, so it starts at the group's framing instead of moving to it */
+	bool bGroupFramingValid;
+
+	/**** Rig snapshots ****/
+	/**
+	 * Carries the camera rig's state over to the player's next pawn after a respawn or level travel, so the camera continues from where it was instead of swooping in
+	 * from the default state. The snapshot is refreshed each frame, and kept in the @ref UCameraRigSnapshotSubsystem across travel
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Player Camera Manager|Snapshot") bool bWarmStartCameraRig;
+
+	/** The latest snapshot of the player's own character */
+	UPROPERTY(BlueprintReadOnly, Transient, Category = "Player Camera Manager|Snapshot") FCameraRigSnapshot RigSnapshot;
+
+	/** The character the snapshot was last captured from or restored to, which isn't restored again */
+	TWeakObjectPtr<ACharacterCameraLogic> RigSnapshotCharacter;
+
+	/**** Spectator director ****/
+	/**
+	 * Automatically picks which player to view. Every camera character has an interest score that's raised by events (damage, and switching targets),
+	 * and the director visits a few players each frame to refresh their state (nearby combatants and target locking). Once every player has been visited,
+	 * the director switches to the most interesting player if they're more interesting than the current view target by the switch margin. \n\n
+	 *
+	 * The events come from each character's replicated DirectorState, since the damage and target locks are only known on the server
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Player Camera Manager|Director") bool bUseSpectatorDirector;
+
+	/** How many players the director visits each frame. A full pass over the players takes the number of players divided by this many frames */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Player Camera Manager|Director", meta=(ClampMin="1", UIMin = "1", UIMax = "32")) int32 DirectorCandidatesPerFrame;
+
+	/** How long it takes the interest of an event to decay to half */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Player Camera Manager|Director", meta=(ClampMin="0.1", UIMin = "0.5", UIMax = "20.0")) float DirectorInterestHalfLife;
+
+	/** How much more interesting another player has to be before the director switches to them */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Player Camera Manager|Director", meta=(ClampMin="0.0", UIMin = "0.0", UIMax = "2.0")) float DirectorSwitchMargin;
+
+	/** The shortest time the director stays on a player before switching */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Player Camera Manager|Director", meta=(ClampMin="0.0", UIMin = "0.0", UIMax = "20.0")) float DirectorMinShotDuration;
+
+	/** The blend time between the director's view targets */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Player Camera Manager|Director", meta=(ClampMin="0.0", UIMin = "0.0", UIMax = "3.0")) float DirectorBlendTime;
+
+	/**
+	 * The size of the director's grid cells. Other players in the same or a neighboring cell count as combatants, so each visit is a few lookups instead of a loop over every player.
+	 * @remarks The cell size is captured when the director is enabled
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Player Camera Manager|Director", meta=(ClampMin="0.0", UIMin = "0.0")) float DirectorCombatRadius;
+
+	/** The interest of each nearby combatant, and of target locking */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Player Camera Manager|Director", meta=(ClampMin="0.0", UIMin = "0.0")) float DirectorCombatantInterest;
+
+	/** The interest added when a player locks on to a new target. The target gets the same interest */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Player Camera Manager|Director", meta=(ClampMin="0.0", UIMin = "0.0")) float DirectorTargetLockInterest;
+
+	/** The interest added for each point of damage, to both the damaged player and the instigator */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Player Camera Manager|Director", meta=(ClampMin="0.0", UIMin = "0.0")) float DirectorDamageInterest;
+
+	/** The players the director is able to view, and the index of each of them */
+	TArray<FCameraDirectorCandidate> DirectorCandidates;
+	TMap<TWeakObjectPtr<AActor>, int32> DirectorCandidateIndices;
+
+	/** The number of candidates in each grid cell at their last visit, and the cell size they're counted with */
+	TMap<FIntPoint, int32> DirectorCellCounts;
+	float DirectorCellSize;
+
+	/** The next candidate the director visits */
+	int32 DirectorCursor;
+
+	/** The most interesting candidate of the current pass */
+	TWeakObjectPtr<AActor> DirectorPassBest;
+	float DirectorPassBestScore;
+
+	/** When the director last switched view targets */
+	double LastDirectorSwitchTime;
+
+	/** Adds the players that are spawned while the director is active */
+	FDelegateHandle DirectorSpawnHandle;
+
+	/** True while the director is active */
+	bool bDirectorActive;
+
+
 public:
 	ABasePlayerCameraManager(const FObjectInitializer& ObjectInitializer);
 
@@ -153,17 +368,207 @@ public:
 	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Camera|Perspectives", DisplayName = "Camera Behavior (Spectator)") 
 	void SpectatorCameraBehavior(float DeltaTime, FTViewTarget& OutVT);
 	virtual void SpectatorCameraBehavior_Implementation(float DeltaTime, FTViewTarget& OutVT);
+
+	/**
+	 * The camera behavior while the camera style is rail. The camera follows the camera rail, looking at the view target
+	 * @remarks Overriding this function replaces the default camera behavior
+	 */
+	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Camera|Perspectives", DisplayName = "Camera Behavior (Rail)") 
+	void RailCameraBehavior(float DeltaTime, FTViewTarget& OutVT);
+	virtual void RailCameraBehavior_Implementation(float DeltaTime, FTViewTarget& OutVT);
+
+	/** Sets the rail the camera follows while the camera style is "Rail" */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Perspectives") virtual void SetCameraRail(ACameraRailActor* Rail);
+
+	/** Returns the rail the camera follows while the camera style is "Rail" */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Perspectives") ACameraRailActor* GetCameraRail() const;
+
+	/**
+	 * The camera behavior while the camera style is group framing. The camera keeps the view target and it's target lock characters on screen,
+	 * with the distance, pitch and field of view that fit the group's bounding sphere
+	 * @remarks Overriding this function replaces the default camera behavior
+	 */
+	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Camera|Perspectives", DisplayName = "Camera Behavior (Group Framing)") 
+	void GroupFramingCameraBehavior(float DeltaTime, FTViewTarget& OutVT);
+	virtual void GroupFramingCameraBehavior_Implementation(float DeltaTime, FTViewTarget& OutVT);
+
+	/** Returns the bounding sphere of the group the camera is framing */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Perspectives") virtual bool GetGroupFramingBounds(FVector& Center, float& Radius) const;
 	
 	
 //--------------------------------------------------------------------------------------------------//
 // Camera calculation functions																		//
 //--------------------------------------------------------------------------------------------------//
-	/** Calculates a smooth interpolation between the camera's position and the target location */
+	/** Updates the group's members and bounds. Changing the members rebuilds the bounds, otherwise only the members that moved update them */
+	virtual void UpdateGroupBounds(AActor* ViewTarget);
+
+	/**
+	 * Calculates a smooth interpolation between the camera's position and the target location, with the PivotLagSpeed of each axis relative to the camera's yaw.
+	 * Axes that are out of the PivotLagBounds use the OutOfBoundsLagSpeed, and are clamped to the bounds
+	 */
 	UFUNCTION(BlueprintCallable, Category = "Camera|Perspectives") virtual FVector CalculateCameraDrag(FVector Current, FVector Target, FRotator CameraRotation, float DeltaTime);
 
+	/** Lags the view behind the view target's pivot, and optionally it's rotation. This is used by the third person and target lock behaviors if bEnablePivotLag is set */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Perspectives") virtual void ApplyPivotLag(FTViewTarget& OutVT, float DeltaTime);
+
 	/** Handle smooth transitions of crouch logic while the player is crouching in air */
 	UFUNCTION(BlueprintCallable, Category = "Camera|Utilities") virtual void InAirCrouchLogic(FTViewTarget& OutVT, float DeltaTime);
-	
+
+	/** Synchronizes the camera manager's transform with the final view, based on the TransformSync mode */
+	virtual void SyncActorTransformToView(const FMinimalViewInfo& POV);
+
+	/** Returns true if there's something attached to the camera manager that relies on it's transform */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Utilities") virtual bool HasAttachedViewDependents() const;
+
+
+//--------------------------------------------------------------------------------------------------//
+// Camera network priority																			//
+//--------------------------------------------------------------------------------------------------//
+	/**
+	 * Returns this player's view on the server. The location and rotation come from the camera cache, which the server fills from the client's camera updates,
+	 * and the field of view is the one the client reported, or reconstructed from the camera cache if it hasn't been reported
+	 */
+	virtual FCameraNetView GetCameraNetView() const;
+
+	/** Returns how much an actor's network priority should be scaled for this player, based on whether it's within the camera's view or behind it */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Networking") virtual float GetNetPriorityScale(const AActor* Actor) const;
+
+	/** Returns false if the actor is behind the camera and further away than the BehindCameraRelevancyDistance */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Networking") virtual bool IsNetRelevantToCamera(const AActor* Actor) const;
+
+	/** Updates the field of view the owning client reported for this player's camera */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Networking") virtual void SetReportedViewFOV(float FOV);
+
+	/**
+	 * Scales an actor's network priority by the viewer's camera, if the viewer uses a camera manager with bUseCameraNetPriority. Call this from GetNetPriority to add this to other actors
+	 * @param Viewer The viewer passed into GetNetPriority, which is usually the connection's player controller
+	 */
+	static float ScaleNetPriorityForViewer(const AActor* Actor, const AActor* Viewer, float Priority);
+
+	/** Returns the camera manager of the viewer if it uses camera driven network priority */
+	static const ABasePlayerCameraManager* GetNetPriorityCameraManager(const AActor* Viewer);
+
+
+//--------------------------------------------------------------------------------------------------//
+// Camera streaming																					//
+//--------------------------------------------------------------------------------------------------//
+	/** Returns the camera's streaming sources: the extrapolated camera location, the pending view target's location during blends, and any prewarmed locations */
+	virtual bool GetStreamingSources(TArray<FWorldPartitionStreamingSource>& StreamingSources) const override;
+
+	/** Returns where the camera is predicted to be after the StreamingPredictionTime */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Streaming") virtual FVector GetPredictedCameraLocation() const;
+
+	/** Streams in a location ahead of time, for camera jumps that can't be predicted from the camera's trajectory (like teleports and instant view target changes) */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Streaming") virtual void AddStreamingPrewarmLocation(FVector Location, float Duration = 2.0f);
+
+	/** Registers or unregisters the camera's streaming sources based on bUseCameraStreamingSource and whether this is a local player */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Streaming") virtual void UpdateStreamingSourceRegistration();
+
+
+//--------------------------------------------------------------------------------------------------//
+// Camera shakes																					//
+//--------------------------------------------------------------------------------------------------//
+	/**
+	 * Plays a procedural camera shake. These don't create any objects, so they're meant for frequent shakes like hit reactions and footsteps
+	 * @returns the shake's handle, or INDEX_NONE if it wasn't played
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Shakes") virtual int32 PlayProceduralShake(const FProceduralCameraShakeParams& Params, float Scale = 1.0f);
+
+	/**
+	 * Plays a procedural camera shake that's scaled by the camera's distance from the epicenter. Shakes outside of the outer radius aren't played
+	 * @returns the shake's handle, or INDEX_NONE if it wasn't played
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Shakes") virtual int32 PlayWorldProceduralShake(const FProceduralCameraShakeParams& Params, FVector Epicenter, float InnerRadius, float OuterRadius, float Falloff = 1.0f);
+
+	/** Stops a procedural camera shake. Shakes that aren't stopped immediately blend out */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Shakes") virtual void StopProceduralShake(int32 Handle, bool bImmediately = false);
+
+	/** Stops every procedural camera shake. Shakes that aren't stopped immediately blend out */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Shakes") virtual void StopAllProceduralShakes(bool bImmediately = false);
+
+	/** Returns the procedural shake modifier, and adds it if it hasn't been added yet */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Shakes") virtual UCameraModifier_ProceduralShake* GetProceduralShakeModifier();
+
+
+
+//--------------------------------------------------------------------------------------------------//
+// Spectator director																				//
+//--------------------------------------------------------------------------------------------------//
+	/** Starts or stops the spectator director. The director is only used by local players */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Director") virtual void SetSpectatorDirectorEnabled(bool bEnabled);
+
+	/** Adds interest to a player, for game events the director should know about (kills, objectives, abilities) */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Director") virtual void ReportDirectorEvent(AActor* Actor, float Interest);
+
+	/** Returns the director's current score of a player, or zero if they aren't a candidate */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Director") virtual float GetDirectorScore(const AActor* Actor) const;
+
+	/** Adds a player the director is able to view */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Director") virtual void AddDirectorCandidate(AActor* Actor);
+
+	/** Removes a player from the director */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Director") virtual void RemoveDirectorCandidate(AActor* Actor);
+
+
+protected:
+	/** Visits the next candidates, and switches to the most interesting one once every candidate has been visited */
+	virtual void UpdateSpectatorDirector();
+
+	/** Refreshes a candidate's state interest and checks whether they've locked on to a new target */
+	virtual void UpdateDirectorCandidate(FCameraDirectorCandidate& Candidate, double Time, float DecayRate);
+
+	/** Switches to the most interesting candidate of the pass, if they're more interesting than the current view target by the switch margin */
+	virtual void TrySwitchDirectorViewTarget(double Time, float DecayRate);
+
+	/**
+	 * Views the director's next player. This sets the view target locally
+	 * @remarks Override this to route the view target through the server on clients, so the server's relevancy follows the director
+	 */
+	virtual void SwitchDirectorViewTarget(AActor* NewViewTarget);
+
+	/** Returns true if the actor is a player the director is able to view */
+	virtual bool IsDirectorCandidate(const AActor* Actor) const;
+
+	/** Returns the decay rate of the event interest, from the half life */
+	float GetDirectorDecayRate() const;
+
+	/** Removes a candidate, and moves the last candidate into it's place */
+	void RemoveDirectorCandidateAt(int32 Index);
+
+	/** Adds spawned players to the director */
+	void OnDirectorActorSpawned(AActor* Actor);
+
+	/** Returns the director's grid cell of a location */
+	FIntPoint GetDirectorCell(const FVector& Location) const;
+
+	/** Moves a candidate between grid cells */
+	void MoveDirectorCandidateCell(FCameraDirectorCandidate& Candidate, const FIntPoint& NewCell);
+
+
+protected:
+	/** Returns true if a character is the local player's own character, which is the only character the snapshot is captured from and restored to */
+	virtual bool IsRigSnapshotCharacter(const ACharacterCameraLogic* InCharacter) const;
+
+	/** Restores the snapshot onto the local player's new character */
+	virtual void TryRestoreRigSnapshot();
+
+	/** Returns the snapshot subsystem, and the local player's controller id it's keyed by */
+	UCameraRigSnapshotSubsystem* GetRigSnapshotSubsystem(int32& OutControllerId) const;
+
+
+protected:
+	/** Tracks the camera's velocity for the streaming prediction */
+	virtual void UpdateStreamingPrediction(float DeltaTime);
+
+	/** Returns a streaming source at a location with the camera's streaming settings */
+	virtual FWorldPartitionStreamingSource MakeStreamingSource(FName Name, const FVector& Location, const FRotator& Rotation) const;
+
+
+public:
+	virtual void InitializeFor(APlayerController* PC) override;
+	virtual void UpdateCamera(float DeltaTime) override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	/** 
 	 * Sets a new ViewTarget.
 	 * @param NewViewTarget - New viewtarget actor.
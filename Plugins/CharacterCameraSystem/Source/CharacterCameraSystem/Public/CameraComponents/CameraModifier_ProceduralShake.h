@@ -0,0 +1,121 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Camera/CameraModifier.h"
+#include "CameraModifier_ProceduralShake.generated.h"
+
+
+/*
+* The settings of a procedural camera shake. Each channel is driven by it's own noise, so the amplitudes are the most a channel is offset
+*/
+USTRUCT(BlueprintType, Category = "Camera")
+struct FProceduralCameraShakeParams
+{
+	GENERATED_USTRUCT_BODY()
+
+public:
+	/** How long the shake plays, in seconds. Zero plays until it's stopped */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Camera", meta=(ClampMin="0.0"))	float Duration = 0.3f;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Camera", meta=(ClampMin="0.0"))	float BlendInTime = 0.05f;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Camera", meta=(ClampMin="0.0"))	float BlendOutTime = 0.15f;
+
+	/** How many times per second the noise changes direction */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Camera", meta=(ClampMin="0.0"))	float Frequency = 12.0f;
+
+	/** The location amplitude relative to the camera (forward, right, up) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Camera")							FVector LocationAmplitude = FVector::ZeroVector;
+
+	/** The rotation amplitude in degrees */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Camera")							FRotator RotationAmplitude = FRotator(1.0, 1.0, 0.0);
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Camera")							float FOVAmplitude = 0.0f;
+
+	/** The noise seed. Shakes with the same seed play the same motion, and zero picks a random seed each time the shake is played */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Camera")							int32 Seed = 0;
+
+};
+
+
+/*
+* An active procedural shake. The channels are stored in two groups of four (location and fov, then rotation) so they're evaluated together
+*/
+struct FProceduralCameraShakeInstance
+{
+	/** The amplitude and noise phase of each channel: (forward, right, up, fov) and (pitch, yaw, roll, unused) */
+	float Amplitude[2][4];
+	float Phase[2][4];
+
+	float Time = 0.0f;
+	float Duration = 0.0f;
+	float BlendInTime = 0.0f;
+	float BlendOutTime = 0.0f;
+	float Frequency = 0.0f;
+	float Scale = 1.0f;
+	int32 Handle = 0;
+
+	/** Returns the blend in and out weight at the current time */
+	float GetWeight() const;
+
+	/** Returns true once the shake has finished */
+	bool IsFinished() const { return Duration > 0.0f && Time >= Duration; }
+};
+
+
+/**
+ * A camera modifier that plays procedural camera shakes without creating any objects. \n\n
+ *
+ * The active shakes are kept in a fixed array, and evaluated together each frame with a seeded gradient noise that's vectorized across each shake's channels.
+ * When the array is full, the shake that's closest to finishing is replaced. Play shakes through ABasePlayerCameraManager::PlayProceduralShake
+ */
+UCLASS()
+class CHARACTERCAMERASYSTEM_API UCameraModifier_ProceduralShake : public UCameraModifier
+{
+	GENERATED_BODY()
+
+public:
+	/** The most shakes that can play at once */
+	static constexpr int32 MaxShakes = 64;
+
+
+protected:
+	/** The active shakes, only the first NumShakes are valid */
+	FProceduralCameraShakeInstance Shakes[MaxShakes];
+	int32 NumShakes;
+
+	/** The handle of the next shake */
+	int32 NextHandle;
+
+
+public:
+	UCameraModifier_ProceduralShake();
+	virtual bool ModifyCamera(float DeltaTime, FMinimalViewInfo& InOutPOV) override;
+
+	/**
+	 * Plays a shake
+	 * @returns the shake's handle, which is used to stop it
+	 */
+	virtual int32 PlayShake(const FProceduralCameraShakeParams& Params, float Scale = 1.0f);
+
+	/** Stops a shake. Shakes that aren't stopped immediately blend out */
+	virtual void StopShake(int32 Handle, bool bImmediately = false);
+
+	/** Stops every shake. Shakes that aren't stopped immediately blend out */
+	virtual void StopAllShakes(bool bImmediately = false);
+
+	/** Returns the number of active shakes */
+	int32 GetNumShakes() const { return NumShakes; }
+
+	/** Evaluates the deterministic gradient noise of four channels at once. The result is within -1 and 1 */
+	static VectorRegister4Float EvaluateNoise(const VectorRegister4Float& Time, const VectorRegister4Float& Phase);
+
+
+protected:
+	/** Removes the finished shakes and advances the others */
+	virtual void AdvanceShakes(float DeltaTime);
+
+	/** Removes a shake by swapping the last shake into it's place */
+	void RemoveShake(int32 Index);
+
+
+};
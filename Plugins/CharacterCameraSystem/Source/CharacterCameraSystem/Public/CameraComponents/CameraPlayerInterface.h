@@ -22,7 +22,7 @@ class CHARACTERCAMERASYSTEM_API ICameraPlayerInterface
 	GENERATED_BODY()
 
 public:
-	/** Returns the camera style. The default styles are "Fixed", "Spectator", "FirstPerson", "ThirdPerson", "TargetLocking", and "Aiming". You can also add your own in the BasePlayerCameraManager class */
+	/** Returns the camera style. The default styles are "Fixed", "Spectator", "FirstPerson", "ThirdPerson", "TargetLocking", "Aiming", "Rail", and "GroupFraming". You can also add your own in the BasePlayerCameraManager class */
 	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Camera|Style")
 	FName GetCameraStyle() const;
 	virtual FName GetCameraStyle_Implementation() const;
@@ -34,7 +34,7 @@ public:
 
 	/**
 	 * Sets the camera style, and calls the OnCameraStyleSet function for handling camera transitions and other logic specific to each style.
-	 * The default styles are "Fixed", "Spectator", "FirstPerson", "ThirdPerson", "TargetLocking", and "Aiming"
+	 * The default styles are "Fixed", "Spectator", "FirstPerson", "ThirdPerson", "TargetLocking", "Aiming", "Rail", and "GroupFraming"
 	 * 
 	 * @remark Overriding this functions removes the default logic for transitioning between styles
 	 * @remark OnCameraStyleSet should be called if TryActivateCameraTransition returns true
@@ -0,0 +1,120 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "CameraRailActor.generated.h"
+
+class USplineComponent;
+
+
+/**
+ * A spline the camera rides along while the camera style is "Rail". The view target is projected onto the rail, and the camera is placed at that point of the rail
+ * (plus the lead distance) looking at the view target. \n\n
+ *
+ * The spline is baked into lookup tables once play begins, so the camera's update doesn't search the spline:
+ *  - An arc length table of points spaced evenly along the rail, so the location at a distance is an index and a lerp
+ *  - A closest point grid over the rail's bounds, where each cell stores the few rail segments that are able to be closest to anything within the cell
+ *
+ * @remarks The tables are in world space, call BuildLookupTables if the rail is moved or edited during play. @see ABasePlayerCameraManager::SetCameraRail
+ */
+UCLASS(Blueprintable)
+class CHARACTERCAMERASYSTEM_API ACameraRailActor : public AActor
+{
+	GENERATED_BODY()
+
+protected:
+	/** The path of the camera */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Camera Rail") TObjectPtr<USplineComponent> Rail;
+
+	/** The distance between the points of the arc length table. Smaller spacing follows the curves of the rail more closely */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera Rail", meta=(ClampMin="1.0", UIMin = "10.0", UIMax = "200.0")) float SampleSpacing;
+
+	/** The size of the closest point grid's cells. This grows if the grid would have more than the MaxGridCells */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera Rail", meta=(ClampMin="10.0", UIMin = "100.0", UIMax = "2000.0")) float GridCellSize;
+
+	/** How far from the rail the closest point grid reaches. View targets further away than this are projected onto the edge of the grid */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera Rail", meta=(ClampMin="0.0", UIMin = "0.0")) float TrackingDistance;
+
+	/** The most cells the closest point grid is allowed to have. Building the grid checks every segment against every cell, so this also limits the build time */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera Rail", meta=(ClampMin="1")) int32 MaxGridCells;
+
+
+public:
+	/** How far along the rail the camera is placed ahead of the view target's projection. Negative values trail behind */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera Rail") float LeadDistance;
+
+	/** The offset from the view target's location the camera looks at */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera Rail") FVector LookAtOffset;
+
+	/** How quickly the camera follows the view target along the rail. Zero snaps to the view target's projection */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera Rail", meta=(ClampMin="0.0", UIMin = "0.0", UIMax = "20.0")) float FollowSpeed;
+
+	/** The camera's field of view on this rail. Zero keeps the camera manager's field of view */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera Rail", meta=(ClampMin="0.0", UIMin = "0.0", UIMax = "170.0")) float FieldOfView;
+
+
+protected:
+	/** The distance along the rail between each point of the arc length table */
+	float SampleStep;
+
+	/** The rail's length when the tables were built */
+	float RailLength;
+
+	/** Whether the rail loops back to it's start */
+	bool bClosedLoop;
+
+	/** The points of the arc length table, evenly spaced along the rail. Each pair of points is a rail segment */
+	TArray<FVector> Samples;
+
+	/** The closest point grid's minimum corner, cell size and dimensions */
+	FVector GridOrigin;
+	float GridCell;
+	FIntVector GridDimensions;
+
+	/** The range of each cell's segments within the GridSegments, the segments of cell N are GridSegments[GridCellStarts[N]] to GridSegments[GridCellStarts[N + 1]] */
+	TArray<int32> GridCellStarts;
+	TArray<int32> GridSegments;
+
+
+public:
+	ACameraRailActor();
+
+	/** Bakes the rail into the arc length table and the closest point grid */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Rail") virtual void BuildLookupTables();
+
+	/** Returns the distance along the rail of the point that's closest to a location */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Rail") float FindClosestDistance(const FVector& Location) const;
+
+	/** Returns the location at a distance along the rail. Distances outside of the rail are clamped, or wrapped for closed loops */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Rail") FVector GetLocationAtDistance(float Distance) const;
+
+	/**
+	 * Evaluates the rail camera for a view target
+	 * @param InOutDistance The camera's distance along the rail, which follows the view target's projection at the FollowSpeed
+	 * @param bSnap Moves the camera directly to the view target's projection, for when the camera first starts using the rail
+	 */
+	virtual void EvaluateView(const FVector& ViewTargetLocation, float DeltaTime, bool bSnap, float& InOutDistance, FVector& OutLocation, FRotator& OutRotation) const;
+
+	/** Returns the rail's spline */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Rail") USplineComponent* GetRail() const;
+
+	/** Returns the size of the lookup tables, in bytes */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Rail") int32 GetLookupTableSize() const;
+
+
+protected:
+	virtual void BeginPlay() override;
+
+	/** Builds the closest point grid from the arc length table's segments */
+	virtual void BuildClosestPointGrid();
+
+	/** Returns the index of the grid cell a location is in, clamped to the grid */
+	int32 GetGridCellIndex(const FVector& Location) const;
+
+	/** Returns the number of rail segments */
+	int32 GetNumSegments() const;
+
+
+};
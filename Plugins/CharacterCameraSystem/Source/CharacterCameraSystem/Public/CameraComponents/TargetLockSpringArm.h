@@ -3,10 +3,87 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "PlayerCameraTypes.h"
 #include "GameFramework/SpringArmComponent.h"
 #include "TargetLockSpringArm.generated.h"
 
 class ACharacterCameraLogic;
+class UCameraRigSubsystem;
+
+
+/** The settings of a camera rig, copied from the spring arm before the rig math runs */
+struct FCameraRigSettings
+{
+	float TargetArmLength = 0.0f;
+	FVector SocketOffset = FVector::ZeroVector;
+	float CameraLagSpeed = 0.0f;
+	float CameraRotationLagSpeed = 0.0f;
+	float CameraLagMaxDistance = 0.0f;
+	float CameraLagMaxTimeStep = 0.0f;
+	float TargetLockTransitionSpeed = 0.0f;
+	bool bUseCameraLagSubstepping = false;
+};
+
+/** The per frame inputs of a camera rig. These are gathered on the game thread so the rig math never has to touch an object */
+struct FCameraRigInput
+{
+	FVector ComponentLocation = FVector::ZeroVector;
+	FVector TargetOffset = FVector::ZeroVector;
+	FQuat DesiredRotation = FQuat::Identity;
+	FVector TargetLocation = FVector::ZeroVector;
+	float DeltaTime = 0.0f;
+	bool bHasTarget = false;
+	bool bDoTrace = false;
+	bool bDoLocationLag = false;
+	bool bDoRotationLag = false;
+};
+
+/** The dynamic state of a camera rig that's carried between frames. Rotations are kept as quaternions, and only converted to rotators for the controller */
+struct FCameraRigState
+{
+	FVector PreviousDesiredLoc = FVector::ZeroVector;
+	FQuat PreviousDesiredRot = FQuat::Identity;
+	bool bTargetTransition = false;
+};
+
+/** The results of the rig math, which are applied to the spring arm during the commit */
+struct FCameraRigOutput
+{
+	FVector ArmOrigin = FVector::ZeroVector;
+	FVector LaggedLocation = FVector::ZeroVector;
+	FVector DesiredLoc = FVector::ZeroVector;
+	FQuat DesiredRotation = FQuat::Identity;
+	FQuat ControlRotation = FQuat::Identity;
+	bool bUpdateControlRotation = false;
+	bool bClampedDist = false;
+};
+
+/** A target's cached aim point, relative to the target's location and rotation */
+struct FTargetLockAimPoint
+{
+	FVector LocalOffset = FVector::ZeroVector;
+	double ResolveTime = 0.0;
+};
+
+/** The camera socket transition of @ref ACharacterCameraLogic's camera orientations, interpolated alongside the rig when it's batched */
+struct FCameraRigSocketBlend
+{
+	FCameraArmBlend ArmBlend;
+	float DeltaTime = 0.0f;
+	bool bActive = false;
+
+	/** The blended arm settings */
+	FVector SocketOffset = FVector::ZeroVector;
+	FVector TargetOffset = FVector::ZeroVector;
+	float TargetArmLength = 0.0f;
+	float CameraLagSpeed = 0.0f;
+	bool bEnableCameraLag = false;
+
+	/** Advances the character's camera arm transition, and splits the blended offset into the socket and target offsets */
+	void Solve();
+};
+
+
 /**
  * 
  */
@@ -19,25 +96,139 @@ public:
 	/** Controls how quickly the camera transitions between targets. @ref ACharacterCameraLogic's SetTargetLockTransitionSpeed value adjusts this */
 	UPROPERTY(BlueprintReadWrite, Category="Target Locking", meta=(ClampMin="0.0", ClampMax="1000.0", UIMin = "0.0", UIMax = "34.0")) float TargetLockTransitionSpeed = 6.4;
 
-	/** Adds an offset to the target lock aim location to help with the camera looking up to each target. @ref ACharacterCameraLogic has values for different camera modes that adjust this when the style updates */
+	/**
+	 * Adds an offset to the target lock aim location to help with the camera looking up to each target. @ref ACharacterCameraLogic has values for different camera modes that adjust this when the style updates.
+	 * This is only used when the camera aims at the target's location, the aim point is already where the camera should look
+	 */
 	UPROPERTY(BlueprintReadWrite, Category="Target Locking") FVector TargetLockOffset = FVector(0.0, 0.0, 34.0);
 
 	/** The current target lock character, derived from @ref ACharacterCameraLogic's target lock logic */
 	UPROPERTY(BlueprintReadWrite, Category="Target Locking") TObjectPtr<AActor> CurrentTarget;
 
+	/**
+	 * Aims at a cached aim point on each target, resolved from the target's aim socket or it's bounds, and predicts where the target will be from it's velocity.
+	 * The target lock offset isn't added to the aim point. Otherwise the camera aims at the target's location with the target lock offset
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Target Locking|Aim Point") bool bUseTargetLockAimPoint = false;
+
+	/** The socket on the target's mesh the camera aims at. Targets without this socket use their bounds instead */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Target Locking|Aim Point") FName TargetLockAimSocket;
+
+	/** Where the aim point is within the target's bounds if there isn't an aim socket, from the bottom (0) to the top (1) of the bounds */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Target Locking|Aim Point", meta=(ClampMin="0.0", ClampMax="1.0")) float TargetLockAimBoundsHeight = 0.5;
+
+	/** How often a target's cached aim point is resolved again, in seconds */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Target Locking|Aim Point", meta=(ClampMin="0.0", UIMin = "0.0", UIMax = "2.0")) float AimPointRefreshInterval = 0.5;
+
+	/**
+	 * How far ahead the aim point is predicted from the target's velocity, in seconds. This should cover the camera's effective latency,
+	 * which is roughly the inverse of the TargetLockTransitionSpeed during target transitions, and the rotation lag otherwise
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Target Locking|Aim Point", meta=(ClampMin="0.0", UIMin = "0.0", UIMax = "0.5")) float AimPredictionTime = 0.1;
+
+	/** The maximum distance the aim point is predicted ahead of the target */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Target Locking|Aim Point", meta=(ClampMin="0.0", UIMin = "0.0")) float MaxAimPredictionDistance = 150.0;
+
+	/**
+	 * Updates this rig with the @ref UCameraRigSubsystem's batched update instead of the component tick. The owning character's camera arm blend is also advanced there instead of in the character's tick
+	 * @remarks This is read during BeginPlay. @see ACharacterCameraLogic::BlendToArmConfiguration
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Camera Rig") bool bUseBatchedRigUpdate = false;
+
+	/**
+	 * Clamps the arm with the baked camera clearance field of the level it's in, and only sweeps against movable objects. Arm origins outside of the loaded fields use a regular sweep.
+	 * The field has to be rebaked whenever the static geometry changes, static geometry that isn't in the field isn't collided with. @see UCameraRigSubsystem::SetClearanceField
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Camera Collision") bool bUseClearanceField = false;
+
 
 protected:
 	UPROPERTY(BlueprintReadWrite, Category="Target Locking") TObjectPtr<ACharacterCameraLogic> Character;
 	UPROPERTY(BlueprintReadWrite, Category="Target Locking") bool bTargetTransition;
 
-	
+	/** The cached aim points of recent targets */
+	TMap<TObjectKey<AActor>, FTargetLockAimPoint> AimPointCache;
+
+	/** The most aim points that are cached, the least recently resolved one is evicted once it's full */
+	static constexpr int32 MaxCachedAimPoints = 8;
+
+	/** True while the rig is registered with the camera rig subsystem */
+	UPROPERTY(BlueprintReadOnly, Transient, Category="Camera Rig") bool bRigBatched;
+
+	/** The world's camera rig subsystem, which has the clearance field */
+	UPROPERTY(Transient) TObjectPtr<UCameraRigSubsystem> RigSubsystem;
+
+	/** The rig's lagged rotation, which replaces the spring arm's PreviousDesiredRot so it isn't converted between rotators and quaternions each frame */
+	FQuat PreviousDesiredQuat = FQuat::Identity;
+
+	/** The distance between the arm's origin and the camera after the collision sweep, or negative until the arm's been updated */
+	float CollisionAdjustedArmLength = -1.0f;
+
+
 public:
 	/** Updates the target lock offset */
 	UFUNCTION(BlueprintCallable, Category="Target Locking") virtual void UpdateTargetLockOffset(FVector Offset);
-	
-	
+
+	/** Returns the location the camera aims at while target locking. This is the target's aim point, or it's location with the target lock offset if aim points aren't used */
+	UFUNCTION(BlueprintCallable, Category="Target Locking") virtual FVector GetTargetLockAimLocation(const AActor* Target);
+
+	/** Finds the aim point of a target from it's aim socket or it's bounds, relative to the target's location and rotation */
+	UFUNCTION(BlueprintCallable, Category="Target Locking") virtual FVector ResolveTargetAimOffset(const AActor* Target) const;
+
+	/** Returns the distance between the arm's origin and the camera from the last update, after the camera's been pulled in by collisions. This is the target arm length until the arm's been updated */
+	UFUNCTION(BlueprintCallable, Category="Camera Collision") float GetCollisionAdjustedArmLength() const;
+
+	/** Returns true if this rig is updated by the camera rig subsystem */
+	UFUNCTION(BlueprintCallable, Category="Camera Rig") bool IsRigBatched() const;
+
+	/** Captures the rig's lag state, relative to the arm's location and desired rotation */
+	virtual void CaptureRigSnapshot(FCameraRigSnapshot& OutSnapshot) const;
+
+	/** Restores the rig's lag state relative to the arm's current location and desired rotation, so the next update continues from it instead of swooping in from the default state */
+	virtual void RestoreRigSnapshot(const FCameraRigSnapshot& Snapshot);
+
+	/** Returns the size of the rig's heap allocations, in bytes */
+	SIZE_T GetAllocatedRigSize() const;
+
+	virtual void GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize) override;
+
+
+//--------------------------------------------------------------------------------------------------------------------------//
+// Rig update						Gather (game thread) -> SolveRig (any thread) -> Commit (game thread)					//
+//--------------------------------------------------------------------------------------------------------------------------//
+	/** Captures the settings, inputs and lag state of the rig. This is where the target lock information is retrieved */
+	virtual void GatherRig(bool bDoTrace, bool bDoLocationLag, bool bDoRotationLag, float DeltaTime, FCameraRigSettings& OutSettings, FCameraRigInput& OutInput, FCameraRigState& OutState);
+
+	/** Captures the owning character's camera socket transition, only used while the rig is batched */
+	virtual void GatherSocketBlend(float DeltaTime, FCameraRigSocketBlend& OutBlend);
+
+	/** The lag and target lock math of the rig. This doesn't access any objects, so it's safe to run on worker threads */
+	static void SolveRig(const FCameraRigSettings& Settings, const FCameraRigInput& Input, FCameraRigState& State, FCameraRigOutput& Output);
+
+	/**
+	 * Returns a rotation that looks along a direction without any roll. Directions that are almost straight up or down can't define a yaw,
+	 * so the previous rotation's yaw is kept instead of snapping, which is what caused jitter while locked onto targets above or below the camera
+	 */
+	static FQuat MakeLookRotation(const FVector& Direction, const FQuat& PreviousRotation);
+
+	/** Applies the socket transition results to the rig */
+	virtual void CommitSocketBlend(const FCameraRigSocketBlend& Blend);
+
+	/** Sweeps for collisions and applies the results of the rig math to the spring arm and the controller */
+	virtual void CommitRig(const FCameraRigInput& Input, const FCameraRigState& State, const FCameraRigOutput& Output);
+
+	/**
+	 * Sweeps the arm for collisions. With a clearance field the static geometry is a lookup and only movable objects are swept
+	 * @returns true if the arm is blocked, and the location it's blocked at
+	 */
+	virtual bool SweepArm(const FVector& ArmOrigin, const FVector& DesiredLoc, FVector& OutHitLocation) const;
+
+
 protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 	virtual void UpdateDesiredArmLocation(bool bDoTrace, bool bDoLocationLag, bool bDoRotationLag, float DeltaTime) override;
-	
-	
+
+
 };
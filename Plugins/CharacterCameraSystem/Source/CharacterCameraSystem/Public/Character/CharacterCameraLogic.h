@@ -5,14 +5,18 @@
 #include "CoreMinimal.h"
 #include "PlayerCameraTypes.h"
 #include "CameraComponents/CameraPlayerInterface.h"
+#include "Debug/CameraNetProfiler.h"
 #include "GameFramework/Character.h"
 #include "CharacterCameraLogic.generated.h"
 
 DECLARE_LOG_CATEGORY_EXTERN(CameraLog, Log, All);
 
 class UCameraComponent;
+class UMeshComponent;
 class UTargetLockSpringArm;
 
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnCameraStateChanged, const FCameraStateChange&, Change);
+
 UCLASS()
 class CHARACTERCAMERASYSTEM_API ACharacterCameraLogic : public ACharacter, public ICameraPlayerInterface
 {
@@ -23,7 +27,7 @@ protected:
 	TObjectPtr<UCameraComponent> FollowCamera;
 
 	/**** Camera information ****/
-	/** The current style of the camera that determines the behavior. The default styles are "Fixed", "Spectator", "FirstPerson", "ThirdPerson", "TargetLocking", and "Aiming". You can also add your own in the BasePlayerCameraManager class */
+	/** The current style of the camera that determines the behavior. The default styles are "Fixed", "Spectator", "FirstPerson", "ThirdPerson", "TargetLocking", "Aiming", "Rail", and "GroupFraming". You can also add your own in the BasePlayerCameraManager class */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera") FName CameraStyle;
 
 	/** These are based on the client, but need to be replicated for late joining clients, so we're using both RPC's and replication to achieve this */
@@ -56,6 +60,46 @@ protected:
 	/** The target arm length of the camera arm. @remarks This overrides the value of the camera arm's target arm length */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera") float TargetArmLength;
 
+	/**
+	 * The camera arm configurations of custom camera styles, or overrides of the default styles. These are added to the camera arm table when it's built
+	 * @remarks Call BuildCameraArmTable after updating these during play
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera") TMap<FName, FCameraStyleConfiguration> CustomCameraStyles;
+
+	
+	/**** Camera arm table ****/
+	/** The id of each camera style in the camera arm table */
+	TMap<FName, int32> CameraStyleIds;
+
+	/** The camera arm configuration of each style and orientation, indexed with the style's id and the orientation. @see GetCameraArmTableIndex */
+	TArray<FCameraArmConfiguration> CameraArmTable;
+
+	/** The rotation mode of each style, indexed with the style's id */
+	TArray<ECameraRotationMode> CameraStyleRotationModes;
+
+	/** The transition between the previous and current camera arm configurations */
+	FCameraArmBlend CameraArmBlend;
+
+	
+	/**** Camera events ****/
+	/**
+	 * Defers the camera style, orientation and target lock updates until the end of the frame, so they're applied and sent to blueprints once no matter how many times they're updated.
+	 * The events are flushed during the character's tick, or with FlushCameraEvents. Updates from after the character's tick (timers, subsystem ticks and later tick groups)
+	 * are flushed once every actor has ticked, and the camera manager flushes it's view target before it updates, so they aren't a frame late
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera|Events") bool bCoalesceCameraEvents;
+
+	/** The camera events waiting to be flushed */
+	ECameraEventFlags PendingCameraEvents;
+
+	/** The end of frame flush for events from after the character's tick */
+	FDelegateHandle PostActorTickFlushHandle;
+
+	/** The camera state the last time the camera events were flushed */
+	UPROPERTY(BlueprintReadOnly, Transient, Category = "Camera|Events") FName FlushedCameraStyle;
+	UPROPERTY(BlueprintReadOnly, Transient, Category = "Camera|Events") ECameraOrientation FlushedCameraOrientation;
+	UPROPERTY(BlueprintReadOnly, Transient, Category = "Camera|Events") TObjectPtr<AActor> FlushedCurrentTarget;
+
 	
 	/**** Camera Transition Replication interval values ****/
 	/** This is true if the player has recently tried to transition between cameras, only edit this during the camera transition handles */
@@ -78,6 +122,33 @@ protected:
 	/** Default camera settings */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera|Post Processing") FPostProcessSettings DefaultCameraSettings;
 
+
+	/**** Near camera fade ****/
+	/**
+	 * Fades and hides the character's meshes for the owning player when the camera arm is pulled in close to the character, from the arm's collision adjusted length.
+	 * This only touches the meshes' owner no see flag and custom primitive data, so it's much cheaper than blending between the HideCamera and DefaultCameraSettings
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera|Near Camera Fade") bool bUseNearCameraFade;
+
+	/** The arm length the meshes are hidden at */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera|Near Camera Fade", meta=(ClampMin="0.0", UIMin = "0.0", UIMax = "200.0")) float NearCameraHideDistance;
+
+	/** The arm length the meshes start to fade at, the fade reaches zero at the hide distance */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera|Near Camera Fade", meta=(ClampMin="0.0", UIMin = "0.0", UIMax = "400.0")) float NearCameraFadeDistance;
+
+	/** How much longer than the hide distance the arm has to get before the meshes are shown again, so an arm resting against a wall doesn't flicker */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera|Near Camera Fade", meta=(ClampMin="0.0", UIMin = "0.0", UIMax = "50.0")) float NearCameraHysteresis;
+
+	/** The custom primitive data index the fade is written to, from 0 (faded) to 1 (visible). Materials that dither the character should read this */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera|Near Camera Fade", meta=(ClampMin="0")) int32 NearCameraFadeDataIndex;
+
+	/** The meshes that are faded, gathered once play begins. @see RefreshNearCameraPrimitives */
+	TArray<TWeakObjectPtr<UMeshComponent>> NearCameraPrimitives;
+
+	/** The fade that was last written to the meshes, and whether they're hidden */
+	float NearCameraFade;
+	bool bNearCameraHidden;
+
 	
 protected:
 	/**** Target lock values ****/
@@ -101,7 +172,108 @@ protected:
 	/** The handle for whether the current target lock character should be sent to the server */
 	UPROPERTY(BlueprintReadWrite, Category = "Camera|Target Locking|Networking") FTimerHandle CurrentTargetDelayHandle;
 
+	/** The quantized field of view that was last reported to the server for camera driven network priority */
+	UPROPERTY(Transient) uint8 ReportedCameraFOV;
+
+
+	/**** Spectator view ****/
+	/**
+	 * Sends the owning client's final camera view to the players spectating this character, so they see exactly what the player sees instead of rebuilding the camera from the character's state.
+	 * The view is only sent while someone is spectating, at the spectator view rate
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera|Networking|Spectating") bool bReplicateSpectatorView;
+
+	/** How many times a second the owning client sends it's view while it's being spectated */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera|Networking|Spectating", meta=(ClampMin="1.0", UIMin = "2.0", UIMax = "30.0")) float SpectatorViewRate;
+
+	/** How often the owning client resends it's view even if it hasn't changed, since the views are sent unreliably and only when they change */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera|Networking|Spectating", meta=(ClampMin="0.1", UIMin = "0.5", UIMax = "5.0")) float SpectatorViewKeyframeInterval;
+
+	/** How far behind the newest view spectators play back the view. This should cover a couple of send intervals so there's always a pair of views to interpolate between */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera|Networking|Spectating", meta=(ClampMin="0.0", UIMin = "0.0", UIMax = "0.5")) float SpectatorViewInterpolationDelay;
+
+	/** Whether another player is viewing this character. This is only replicated to the owner, and updated on the server at the spectator check interval */
+	UPROPERTY(ReplicatedUsing = OnRep_IsBeingSpectated, BlueprintReadOnly, Transient, Category = "Camera|Networking|Spectating") bool bIsBeingSpectated;
+
+	/** The owner's latest view, replicated to everyone else while the character is being spectated */
+	UPROPERTY(ReplicatedUsing = OnRep_SpectatorView, Transient) FSpectatorViewSample SpectatorView;
+
+	/** The last view the owner sent, which isn't sent again until it changes */
+	FSpectatorViewSample SentSpectatorView;
+
+	/** When the owner is able to send it's view again */
+	double NextSpectatorViewTime;
+
+	/** When the owner sends it's view again even if it hasn't changed */
+	double NextSpectatorKeyframeTime;
+
+	/** When the server checks whether the character is being spectated again */
+	double NextSpectatorCheckTime;
+
+	/** The views a spectating client has received */
+	FSpectatorViewBuffer SpectatorViewBuffer;
+
+
+	/**** Spectator director ****/
+	/**
+	 * The damage and target lock totals spectator directors build the character's interest from, kept up to date on the server.
+	 * This is only replicated while any player is spectating. @see ABasePlayerCameraManager::bUseSpectatorDirector
+	 */
+	UPROPERTY(ReplicatedUsing = OnRep_DirectorState, BlueprintReadOnly, Transient, Category = "Camera|Networking|Spectating") FCameraDirectorState DirectorState;
+
+	/** Whether any player is spectating instead of playing, updated on the server at the spectator check interval */
+	bool bHasSpectators;
+
+#if WITH_CAMERA_NET_PROFILER
+	/** The replicated spectating values the server last recorded as sent, for the camera net profiler */
+	bool bRecordedIsBeingSpectated;
+	FSpectatorViewSample RecordedSpectatorView;
+	FCameraDirectorState RecordedDirectorState;
+#endif
+
 	
+	/**** Camera view history ****/
+	/**
+	 * Has the owning client report it's camera view to the server at the view history rate, which the server keeps in a short history for validating shots against where
+	 * the player was actually aiming at the time. The control rotation isn't enough for this, since the target lock arm overrides it each frame
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera|Networking|View History") bool bRecordCameraViewHistory;
+
+	/** How many times a second the owning client reports it's view for the view history. The history keeps the last 64 views, so this also decides how far back it reaches */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera|Networking|View History", meta=(ClampMin="1.0", UIMin = "5.0", UIMax = "60.0")) float CameraViewHistoryRate;
+
+	/** Reported views further than this from the character on the server are rejected */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera|Networking|View History", meta=(ClampMin="0.0", UIMin = "0.0")) float CameraViewHistoryMaxDistance;
+
+	/** The views the owning client has reported, on the server */
+	FCameraViewHistory CameraViewHistory;
+
+	/** When the owner reports it's view for the history again */
+	double NextCameraViewHistoryTime;
+
+	
+	/**** Target re-evaluation ****/
+	/** Continuously re-scores the target lock characters in the background while target locking, and switches targets or breaks the target lock based on those scores. @see UCameraTargetingSubsystem */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera|Target Locking|Re-evaluation") bool bReevaluateTargets;
+
+	/** Targets further away than this are out of range. The target lock switches to another target or breaks once the current target is out of range */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera|Target Locking|Re-evaluation", meta=(ClampMin="0.0", UIMin = "0.0")) float TargetLockBreakDistance;
+
+	/** How much better another target's score has to be before switching to it. This prevents the camera from flickering between targets */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera|Target Locking|Re-evaluation", meta=(ClampMin="0.0", UIMin = "0.0", UIMax = "1.0")) float TargetSwitchScoreMargin;
+
+	/** How much the target's angle from where the character is looking affects it's score */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera|Target Locking|Re-evaluation", meta=(ClampMin="0.0", UIMin = "0.0", UIMax = "1.0")) float TargetAngleScoreWeight;
+
+	/** How much the target's distance from the character affects it's score */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera|Target Locking|Re-evaluation", meta=(ClampMin="0.0", UIMin = "0.0", UIMax = "1.0")) float TargetDistanceScoreWeight;
+
+
+	/**** Significance ****/
+	/** Registers this character with the camera significance, which reduces how often it ticks and animates based on what the local players' cameras show. @see UCameraSignificanceSubsystem */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera|Significance") bool bUseCameraSignificance;
+
+
 	/**** Other ****/
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera|Debug") bool bDebugCameraStyle;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera|Debug") bool bDebugCameraOrientation;
@@ -112,10 +284,19 @@ public:
 	virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
 	virtual void Tick(float DeltaTime) override;
 	ACharacterCameraLogic(const FObjectInitializer& ObjectInitializer);
+	virtual void PostInitializeComponents() override;
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+	virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
+	virtual void GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize) override;
 
 	
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void NotifyControllerChanged() override;
+
+	/** Registers the character with the camera significance, or unregisters it once it's locally controlled. The controller isn't known during BeginPlay on clients, so this is also called when it changes */
+	virtual void UpdateCameraSignificanceRegistration();
 
 	
 //-------------------------------------------------------------------------------------//
@@ -124,16 +305,19 @@ protected:
 public:
 	/**
 	 * Sets the camera style, and calls the OnCameraStyleSet function for handling camera transitions and other logic specific to each style.
-	 * The default styles are "Fixed", "Spectator", "FirstPerson", "ThirdPerson", "TargetLocking", and "Aiming"
+	 * The default styles are "Fixed", "Spectator", "FirstPerson", "ThirdPerson", "TargetLocking", "Aiming", "Rail", and "GroupFraming"
 	 * 
 	 * @remark Overriding this functions removes the default logic for transitioning between styles
 	 * @remark OnCameraStyleSet should be called if TryActivateCameraTransition returns true
 	 */
 	virtual void SetCameraStyle_Implementation(FName Style) override;
 	
-	/** Handles transitioning between different camera styles and logic specific to each style */
+	/** Handles transitioning between different camera styles and logic specific to each style. This is deferred until the camera events are flushed if bCoalesceCameraEvents is set */
 	UFUNCTION(BlueprintCallable, Category = "Camera|Style") virtual void OnCameraStyleSet();
 
+	/** Updates the character's rotation and the camera arm for the current camera style */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Style") virtual void ApplyCameraStyle();
+
 	/** Blueprint function handling transitioning between different camera styles and logic specific to each style */
 	UFUNCTION(BlueprintImplementableEvent, Category="Camera|Style", meta = (DisplayName = "On Camera Style Set"))
 	void BP_OnCameraStyleSet();
@@ -164,8 +348,11 @@ public:
 	 */
 	virtual void SetCameraOrientation_Implementation(ECameraOrientation Orientation) override;
 
-	/** Handles transitioning between different camera styles and logic specific to each style */
+	/** Handles transitioning between different camera orientations. This is deferred until the camera events are flushed if bCoalesceCameraEvents is set */
 	UFUNCTION(BlueprintCallable, Category = "Camera|Orientation") virtual void OnCameraOrientationSet();
+
+	/** Updates the camera arm for the current camera orientation */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Orientation") virtual void ApplyCameraOrientation();
 	
 	/** Blueprint function handling transitioning between different camera styles and logic specific to each style */
 	UFUNCTION(BlueprintImplementableEvent, Category = "Camera|Orientation", meta = (DisplayName = "On Camera Orientation Set"))
@@ -184,11 +371,68 @@ public:
 	 */
 	UFUNCTION(BlueprintCallable, Category = "Camera|Orientation") virtual void SetRotationToCamera();
 	
-	/** Adjusts the location of the third person camera */
+	/** Adjusts the location of the third person camera. The camera arm blends to the new settings. @see BlendToArmConfiguration */
 	UFUNCTION(BlueprintCallable, Category = "Camera|Orientation") virtual void UpdateCameraArmSettings(FVector CameraLocation, float SpringArmLength, bool bEnableCameraLag, float LagSpeed = 0);
 
-	/** Updates the camera's target offset to transition to the target offset */
-	UFUNCTION(BlueprintCallable, Category = "Camera|Orientation") virtual void UpdateCameraSocketLocation(FVector Offset, float DeltaTime);
+	/** Updates the camera's target offset to transition to the target offset. This isn't called by the character, the transitions are blended by the camera arm blend instead */
+	UE_DEPRECATED(5.2, "The camera arm transitions are handled by the camera arm blend, use BlendToArmConfiguration or UpdateCameraArmSettings instead")
+	UFUNCTION(BlueprintCallable, Category = "Camera|Orientation", meta = (DeprecatedFunction, DeprecationMessage = "The camera arm transitions are handled by the camera arm blend, use Blend To Arm Configuration or Update Camera Arm Settings instead")) virtual void UpdateCameraSocketLocation(FVector Offset, float DeltaTime);
+
+	
+	/**
+	 * Builds the camera arm table from the camera offsets, arm length, lag and custom camera styles. Every style has a configuration for each orientation,
+	 * so style and orientation updates are a single lookup. This is built once the components are initialized
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Arm") virtual void BuildCameraArmTable();
+
+	/**
+	 * Finds the camera arm configuration and rotation mode of a style and orientation
+	 * @returns false if the style isn't in the camera arm table
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Arm") virtual bool FindCameraArmConfiguration(FName Style, ECameraOrientation Orientation, FCameraArmConfiguration& OutConfiguration, ECameraRotationMode& OutRotationMode) const;
+
+	/** Starts a transition from the camera arm's current settings to another configuration, which is blended over the camera orientation transition speed */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Arm") virtual void BlendToArmConfiguration(const FCameraArmConfiguration& Configuration);
+
+	/** Updates the camera arm transition. Batched rigs are updated in the camera rig subsystem instead */
+	virtual void UpdateCameraArmBlend(float DeltaTime);
+
+
+	/** Gathers the character's meshes for the near camera fade. Call this after adding or removing meshes from the character */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Near Camera Fade") virtual void RefreshNearCameraPrimitives();
+
+	/** Captures the camera rig's lag, arm settings, style and orientation, for restoring onto another character. @see UCameraRigSnapshotSubsystem */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Snapshot") virtual FCameraRigSnapshot CaptureCameraRigSnapshot() const;
+
+	/**
+	 * Restores a camera rig snapshot, so the camera continues from where it was on the previous character instead of swooping in from the default state.
+	 * The style is set the same way as a player switching styles, so it's throttled by the transition delay, and the arm blends from the snapshot's settings to the style's settings.
+	 * Target locking and aiming need a target or input the new character doesn't have yet, so they're restored as the character's default style
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Snapshot") virtual void RestoreCameraRigSnapshot(const FCameraRigSnapshot& Snapshot);
+
+	
+protected:
+	/** Adds a style's configurations to the camera arm table, or replaces them if the style is already in the table */
+	virtual void AddCameraStyleToArmTable(FName Style, const FCameraStyleConfiguration& Configuration);
+
+	/** Applies a camera arm configuration to the camera arm */
+	virtual void ApplyCameraArmConfiguration(const FCameraArmConfiguration& Configuration);
+
+	/** Returns the camera arm's current settings */
+	virtual FCameraArmConfiguration GetCurrentArmConfiguration() const;
+
+	/** Fades and hides the character's meshes from the camera arm's collision adjusted length */
+	virtual void UpdateNearCameraFade();
+
+	/** Writes the fade and hidden state to the character's meshes */
+	virtual void ApplyNearCameraFade(float Fade, bool bHidden);
+
+	/** Returns the index of a style id and orientation in the camera arm table */
+	static int32 GetCameraArmTableIndex(int32 StyleId, ECameraOrientation Orientation);
+
+	/** The number of camera orientations, and the stride of the camera arm table */
+	static constexpr int32 NumCameraOrientations = static_cast<int32>(ECameraOrientation::Custom) + 1;
 
 	
 //--------------------------------------------------------------------------------------------------------------------------//
@@ -212,6 +456,40 @@ public:
 	   float Radius = 640.0f
    );
 
+	/**
+	 * The target selection logic of AdjustCurrentTarget, without any side effects. The locations of the targets are passed in so this is safe to run on worker threads. \n\n
+	 * TargetLockData is the buffer the sorted target information is written to, and OutNextTarget is only valid if this returns Selected.
+	 *
+	 * @remarks The batched target selection in @ref UCameraTargetingSubsystem uses this, so the results are identical to AdjustCurrentTarget's default logic
+	 */
+	static ETargetSelectionResult SelectNextTarget(
+		const FVector& PlayerLocation,
+		const FRotator& BaseAimRotation,
+		const AActor* Self,
+		const AActor* PreviousTarget,
+		TArrayView<AActor* const> Targets,
+		TArrayView<const FVector> TargetLocations,
+		EPreviousTargetLockOrientation NextTargetDirection,
+		TArray<FTargetLockInformation>& OutTargetLockData,
+		FTargetLockInformation& OutNextTarget
+	);
+
+	/** Sets the next active target and sends it to the server */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Target Locking") virtual void ApplyTargetSelection(AActor* NextTarget);
+
+	/** Clears the current target, and transitions back to third person if the character is target locking. This is used once there aren't any targets left */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Target Locking") virtual void BreakTargetLock();
+
+	/**
+	 * Scores a target for the target re-evaluation, lower scores are better targets. This is based on the target's distance and it's angle from where the character is looking
+	 * @returns MAX_FLT if the target isn't valid or is out of range
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Target Locking") virtual float ScoreTarget(const AActor* Target) const;
+
+	/** Returns true if the actor is still able to be targeted. Override this to add logic for targets that have died */
+	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Camera|Target Locking") bool IsTargetValid(const AActor* Target) const;
+	virtual bool IsTargetValid_Implementation(const AActor* Target) const;
+
 	/**
 	 * Logic once the target lock character has been updated
 	 * @remarks There's also a blueprint event for adding logic to this
@@ -219,6 +497,9 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Camera|Target Locking") virtual void OnTargetLockCharacterUpdated();
 	// TODO: Add logic on target transitions to clear invalid target handles
 
+	/** Updates the target lock offset and the target re-evaluation for the current target, and clears the target if the character isn't target locking */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Target Locking") virtual void ApplyTargetLockCharacter();
+
 	/** Blueprint function handling transitioning between different target lock characters */
 	UFUNCTION(BlueprintImplementableEvent, Category = "Camera|Target Locking", meta = (DisplayName = "On Target Lock Character Updated"))
 	void BP_OnTargetLockCharacterUpdated();
@@ -237,10 +518,125 @@ protected:
 	/** Resets the target lock delay to allow transition between targets */
 	UFUNCTION(BlueprintCallable, Category = "Camera|Target Locking") virtual void ResetCurrentTargetDelay();
 	
+	/** Adds or removes the character from the target re-evaluation based on whether it's target locking */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Target Locking") virtual void UpdateTargetReevaluation();
+
 	/** Clears the array of target lock characters */
 	UFUNCTION(BlueprintCallable, Category = "Camera|Target Locking") virtual void ClearTargetLockCharacters(UPARAM(ref) TArray<AActor*>& ActorsToIgnore);
 	
 	
+//-------------------------------------------------------------------------------------//
+// Camera events																	   //
+//-------------------------------------------------------------------------------------//
+public:
+	/** Broadcast once per frame with every camera state change of that frame, if bCoalesceCameraEvents is set */
+	UPROPERTY(BlueprintAssignable, Category = "Camera|Events") FOnCameraStateChanged OnCameraStateChanged;
+
+	/** Applies the pending camera updates, and sends the camera events once with the previous and current camera state */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Events") virtual void FlushCameraEvents();
+
+	/** Blueprint event with every camera state change of the frame, sent once the camera events are flushed */
+	UFUNCTION(BlueprintImplementableEvent, Category = "Camera|Events", meta = (DisplayName = "On Camera State Changed"))
+	void BP_OnCameraStateChanged(const FCameraStateChange& Change);
+
+
+protected:
+	/** Marks camera events to be applied and sent during the next flush */
+	virtual void MarkCameraEventsDirty(ECameraEventFlags Events);
+
+	/** Flushes the camera events once every actor has ticked */
+	virtual void OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaTime);
+
+	
+//-------------------------------------------------------------------------------------//
+// Networking																		   //
+//-------------------------------------------------------------------------------------//
+public:
+	/** Scales the network priority by the viewer's camera if it uses camera driven network priority. @see ABasePlayerCameraManager::bUseCameraNetPriority */
+	virtual float GetNetPriority(const FVector& ViewPos, const FVector& ViewDir, AActor* Viewer, AActor* ViewTarget, UActorChannel* InChannel, float Time, bool bLowBandwidth) override;
+
+	/** Characters behind the viewer's camera aren't relevant past the camera manager's BehindCameraRelevancyDistance */
+	virtual bool IsNetRelevantFor(const AActor* RealViewer, const AActor* ViewTarget, const FVector& SrcLocation) const override;
+
+
+protected:
+	/** Reports the camera's field of view to the server when it changes, for camera driven network priority */
+	virtual void TryReportCameraFOV();
+
+	/** Sends the camera's field of view to the server, quantized to a degree. This is reliable since it's only sent when it changes */
+	UFUNCTION(Server, Reliable) virtual void Server_ReportCameraFOV(uint8 FOV);
+
+
+public:
+	/**
+	 * Returns the replicated view of the character's owner, interpolated from the views that have been received. This is what the character's spectators see
+	 * @returns false if the view isn't replicated, or nothing has been received yet
+	 */
+	virtual bool GetSpectatorView(FVector& OutLocation, FRotator& OutRotation, float& OutFOV) const;
+
+	/** Returns true if another player is viewing this character. This is only valid on the server and the owning client */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Networking") bool IsBeingSpectated() const;
+
+	/** Clears the views that have been received, so a new spectating session doesn't play back the views from the last one */
+	virtual void ResetSpectatorView();
+
+
+protected:
+	/** Sends the owner's camera view to the server while the character is being spectated */
+	virtual void TryReportSpectatorView();
+
+	/** Updates whether any other player is viewing this character, and whether anyone is spectating at all, on the server */
+	virtual void UpdateSpectatedState();
+
+	/** Sends the owner's camera view to the server, which replicates it to the spectators */
+	UFUNCTION(Server, Unreliable) virtual void Server_ReportSpectatorView(const FSpectatorViewSample& View);
+
+	/** Buffers the replicated view for interpolation */
+	UFUNCTION() virtual void OnRep_SpectatorView();
+
+	/** Sends the owner's view right away once it's being spectated, since the last view it sent may have been dropped or sent to a previous spectator */
+	UFUNCTION() virtual void OnRep_IsBeingSpectated();
+
+
+public:
+	/** Returns the totals spectator directors build the character's interest from */
+	const FCameraDirectorState& GetDirectorState() const;
+
+
+protected:
+	/** Updates the target lock part of the director state, on the server */
+	virtual void UpdateDirectorState();
+
+	/** Adds damage to the director state of the damaged character and the instigator's character, on the server */
+	UFUNCTION() virtual void OnDirectorStateDamaged(AActor* DamagedActor, float Damage, const UDamageType* DamageType, AController* InstigatedBy, AActor* DamageCauser);
+
+	/** Records the replicated director state with the camera net profiler */
+	UFUNCTION() virtual void OnRep_DirectorState();
+
+
+public:
+	/**
+	 * Returns where the owning client's camera was at a point in the server's time, interpolated from the view history. This is only valid on the server
+	 * @param ServerTime The server world time to look up, usually the client's estimate of the server time that was sent with a shot
+	 * @returns false if there isn't a view history, or the time is older than the history reaches
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Networking") virtual bool GetCameraViewAtTime(double ServerTime, FVector& OutLocation, FRotator& OutRotation) const;
+
+	/** Returns the view history of the owning client. This is only valid on the server */
+	virtual const FCameraViewHistory& GetCameraViewHistory() const;
+
+
+protected:
+	/** Reports the owner's camera view to the server for the view history */
+	virtual void TryReportCameraViewHistory();
+
+	/** Sends the owner's camera view to the server for the view history */
+	UFUNCTION(Server, Unreliable) virtual void Server_ReportCameraView(const FCameraViewReport& View);
+
+	/** Validates a reported view, and adds it to the view history */
+	virtual void RecordCameraView(const FCameraViewReport& View);
+
+
 //-------------------------------------------------------------------------------------//
 // Utility																			   //
 //-------------------------------------------------------------------------------------//
@@ -263,6 +659,30 @@ public:
 	/** Returns the camera arm's length */
 	UFUNCTION(BlueprintCallable, Category = "Camera|Utilities") virtual float GetCameraArmLength() const;
 
+	/** Returns the camera offset the camera socket is transitioning to */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Utilities") virtual FVector GetTargetCameraOffset() const;
+
+	/** Returns the camera orientation transition speed */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Utilities") virtual float GetCameraOrientationTransitionSpeed() const;
+
+	/**
+	 * Returns the memory the camera system adds to this character, by category. This includes the camera arm and camera components, and everything this class adds on top of a regular character
+	 * @see Camera.MemReport
+	 */
+	virtual void GetCameraMemoryBreakdown(FCameraMemoryBreakdown& OutBreakdown) const;
+
+	/** Logs an error if the character's camera memory is over the Camera.Memory.Budget, which fails automation and functional test runs */
+	virtual void CheckCameraMemoryBudget() const;
+
+	/** Returns the camera arm transition */
+	virtual const FCameraArmBlend& GetCameraArmBlend() const;
+
+	/** Updates the camera arm transition, used by the camera rig subsystem to store batched results */
+	virtual void SetCameraArmBlend(const FCameraArmBlend& Blend);
+
+	/** Returns how much better another target's score has to be before the target re-evaluation switches to it */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Target Locking") virtual float GetTargetSwitchScoreMargin() const;
+
 	/** Updates the target lock transition speed for the character and the camera arm */
 	UFUNCTION(BlueprintCallable, Category = "Camera|Target Locking") virtual void SetTargetLockTransitionSpeed(float Speed);
 	
@@ -0,0 +1,33 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "CameraClearanceBakeCommandlet.generated.h"
+
+
+/**
+ * Bakes a level's camera clearance field. @see UCameraClearanceField \n\n
+ *
+ * UnrealEditor-Cmd.exe <Project> -run=CameraClearanceBake -Map=/Game/Maps/Demo -Asset=/Game/Camera/CF_Demo [-CellSize=100] [-ArmLength=800] [-ProbeSize=16.4] [-Padding=200] \n
+ * The bounds are the static geometry of the map with the padding added, and the asset is created if it doesn't exist
+ *
+ * @remarks Only the map's persistent level is baked. World partition actors aren't loaded by the commandlet, so bake those levels with UCameraClearanceField::Bake after loading the region
+ */
+UCLASS()
+class CHARACTERCAMERASYSTEM_API UCameraClearanceBakeCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UCameraClearanceBakeCommandlet();
+	virtual int32 Main(const FString& Params) override;
+
+
+protected:
+	/** Returns the bounds of the collidable static geometry in the world */
+	virtual FBox GetStaticGeometryBounds(UWorld* World) const;
+
+
+};
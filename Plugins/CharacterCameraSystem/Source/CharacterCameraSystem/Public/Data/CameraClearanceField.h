@@ -0,0 +1,94 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "CameraClearanceField.generated.h"
+
+
+/**
+ * A baked grid of how far the camera arm can extend from each cell before it hits static geometry, stored for a number of direction buckets. \n\n
+ *
+ * The spring arm clamps it's length with a lookup into this grid, and only sweeps against movable objects, which removes the static collision sweep from the rig's update.
+ * Each cell stores the max arm length of each direction bucket, quantized to a byte of the MaxArmLength. The bake sweeps a probe that's widened by the cell's half diagonal
+ * and the bucket's spread at each length, so the clearance is safe from anywhere within the cell in any direction within the bucket. Larger cells and fewer buckets make it more conservative. \n\n
+ *
+ * The field only knows the static geometry from when it was baked, so rebake it whenever the level's static geometry changes. \n\n
+ *
+ * Bake this for each level with the CameraClearanceBake commandlet, and assign it to the level with UCameraRigSubsystem::SetClearanceField
+ *
+ * @remarks Camera arm origins outside of the grid fall back to a regular collision sweep
+ */
+UCLASS(BlueprintType)
+class CHARACTERCAMERASYSTEM_API UCameraClearanceField : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	/** The minimum corner of the grid */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Clearance Field") FVector Origin;
+
+	/** The size of each cell */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Clearance Field", meta=(ClampMin="10.0")) float CellSize;
+
+	/** The number of cells along each axis */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Clearance Field") FIntVector Dimensions;
+
+	/** The number of yaw direction buckets in each cell */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Clearance Field", meta=(ClampMin="1", ClampMax="64")) int32 NumYawBuckets;
+
+	/** The number of pitch direction buckets in each cell */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Clearance Field", meta=(ClampMin="1", ClampMax="32")) int32 NumPitchBuckets;
+
+	/** The longest arm length the field stores. Clearances at or above this are unobstructed */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Clearance Field", meta=(ClampMin="1.0")) float MaxArmLength;
+
+	/** The radius of the sweeps used while baking, which should match the spring arm's ProbeSize */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Clearance Field", meta=(ClampMin="0.0")) float ProbeSize;
+
+	/** The collision channel of the sweeps used while baking, which should match the spring arm's ProbeChannel */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Clearance Field") TEnumAsByte<ECollisionChannel> ProbeChannel;
+
+
+protected:
+	/** The quantized clearance of each cell's direction buckets, with the buckets of a cell stored together */
+	UPROPERTY() TArray<uint8> Clearance;
+
+
+public:
+	UCameraClearanceField();
+
+	/**
+	 * Finds the max arm length in a direction from a location
+	 * @returns false if the location is outside of the grid
+	 */
+	bool GetMaxArmLength(const FVector& Location, const FVector& Direction, float& OutMaxArmLength) const;
+
+	/** Returns true if a location is within the grid */
+	bool Contains(const FVector& Location) const;
+
+	/** Returns true if the field has been baked */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Clearance Field") bool IsBaked() const;
+
+	/** Returns the size of the baked clearance data, in bytes */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Clearance Field") int32 GetClearanceDataSize() const;
+
+#if WITH_EDITOR
+	/**
+	 * Bakes the clearance of the static geometry within the bounds. Only loaded static geometry is included, so world partition regions need to be loaded first
+	 * @returns false if the grid would be too large
+	 */
+	virtual bool Bake(UWorld* World, const FBox& Bounds);
+#endif
+
+
+protected:
+	/** Returns the direction bucket of a direction */
+	int32 GetDirectionBucket(const FVector& Direction) const;
+
+	/** Returns the direction at the center of a direction bucket */
+	FVector GetBucketDirection(int32 YawBucket, int32 PitchBucket) const;
+
+
+};
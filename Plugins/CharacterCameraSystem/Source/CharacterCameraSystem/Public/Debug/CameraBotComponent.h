@@ -0,0 +1,78 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "CameraBotComponent.generated.h"
+
+class ACharacterCameraLogic;
+
+
+/**
+ * Scripted camera input for load testing. The bot moves and looks around, and spams camera style switches, orientation swaps and target cycling
+ * at random intervals, which drives the camera's RPCs and throttles the same way a player would. \n\n
+ *
+ * Clients launched with -CameraBots add this to their character. @see UCameraLoadTestSubsystem and Scripts/CameraLoadTest.py
+ */
+UCLASS(ClassGroup = "Camera", meta = (BlueprintSpawnableComponent))
+class CHARACTERCAMERASYSTEM_API UCameraBotComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	/** The range of time between camera style switches */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera Bot") FVector2D StyleSwitchInterval;
+
+	/** The range of time between orientation swaps */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera Bot") FVector2D OrientationSwapInterval;
+
+	/** The range of time between target adjustments while target locking */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera Bot") FVector2D TargetCycleInterval;
+
+	/** The radius targets are gathered from */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera Bot") float TargetRadius;
+
+	/** The camera styles the bot switches between */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera Bot") TArray<FName> Styles;
+
+	/** How quickly the bot turns the camera, in degrees per second */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera Bot") float LookSpeed;
+
+
+protected:
+	UPROPERTY(Transient) TObjectPtr<ACharacterCameraLogic> Character;
+
+	/** The time until each of the next actions */
+	float NextStyleSwitch;
+	float NextOrientationSwap;
+	float NextTargetCycle;
+
+	/** The bot's random stream, seeded with -CameraBotSeed so runs are repeatable */
+	FRandomStream Stream;
+
+
+public:
+	UCameraBotComponent();
+	virtual void BeginPlay() override;
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+
+protected:
+	/** Switches to a random camera style */
+	virtual void SwitchStyle();
+
+	/** Swaps to a random shoulder */
+	virtual void SwapOrientation();
+
+	/** Gathers the nearby targets and adjusts the current target in a random direction */
+	virtual void CycleTarget();
+
+	/** Moves and turns the character */
+	virtual void UpdateMovement(float DeltaTime);
+
+	/** Returns a random time within an interval */
+	float GetRandomInterval(const FVector2D& Interval) const;
+
+
+};
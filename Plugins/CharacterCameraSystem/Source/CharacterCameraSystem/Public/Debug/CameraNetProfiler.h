@@ -0,0 +1,94 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/CoreNetTypes.h"
+
+#define WITH_CAMERA_NET_PROFILER !UE_BUILD_SHIPPING
+
+class AActor;
+
+
+/** What happened to a camera RPC or replicated camera property */
+enum class ECameraNetEvent : uint8
+{
+	/** Sent to the remote connection */
+	Sent,
+
+	/** Received from the remote connection */
+	Received,
+
+	/** Not sent because of the camera's replication throttles */
+	Throttled,
+
+	/**
+	 * Sent while the connection was saturated (not net ready), so the engine likely discarded it. This is only checked for unreliable RPCs,
+	 * packets that are lost on the wire after being sent still count as sent
+	 */
+	Saturated
+};
+
+
+/** The counters of a camera RPC or replicated property on a connection */
+struct FCameraNetCounters
+{
+	uint32 Sent = 0;
+	uint32 Received = 0;
+	uint32 Throttled = 0;
+	uint32 Saturated = 0;
+	uint64 Bytes = 0;
+};
+
+
+/**
+ * Counts the camera's RPCs and replicated properties for each connection, to size the camera's share of a player's bandwidth. \n\n
+ *
+ * The counters are also sent to the camera stat group and as Unreal Insights timing counters (Camera/Net/...), and Camera.Net.Dump logs the connections and RPCs with the most traffic.
+ * The bytes are estimated from the parameters, they don't include the bunch and packet overhead. \n\n
+ *
+ * Replicated properties are recorded as sent when they change on the server, to each connection with the actor open. The driver's packets aren't read, so this can't see packet loss, and nothing is added to Networking Insights. Use Networking Insights or stat net for the actual traffic and loss
+ *
+ * @remarks Record with CAMERA_NET_RECORD and CAMERA_NET_RECORD_REPLICATED, which are compiled out of shipping builds
+ */
+struct CHARACTERCAMERASYSTEM_API FCameraNetProfiler
+{
+	/**
+	 * Records a camera RPC or replicated property of an actor. Networking that doesn't go over a connection (standalone games, and the listen server's own character) isn't recorded
+	 * @param Bytes The estimated size of the parameters or property
+	 */
+	static void Record(const AActor* Actor, FName Name, ECameraNetEvent Event, int32 Bytes = 0);
+
+	/**
+	 * Records a replicated property that changed on the server as sent to each client connection that has the actor's channel open and passes the property's owner condition.
+	 * Call this when the property changes, the clients record it with Record when it's received
+	 * @param Bytes The estimated size of the property
+	 */
+	static void RecordReplicated(const AActor* Actor, FName Name, ELifetimeCondition Condition, int32 Bytes);
+
+	/** Returns Sent if an unreliable RPC from the actor would be sent, or Saturated if the connection isn't ready for it */
+	static ECameraNetEvent GetUnreliableSendEvent(const AActor* Actor);
+
+	/** Logs the connection and RPC pairs with the most bytes */
+	static void Dump(int32 NumEntries);
+
+	/** Clears the counters */
+	static void Reset();
+
+	/** Returns the estimated size of a name. Hardcoded names are sent as an index, and the others as a string */
+	static int32 EstimateNameSize(FName Name);
+
+	/** Returns the estimated size of an object reference, which is sent as a network guid once the object has been mapped */
+	static int32 EstimateObjectSize(const UObject* Object);
+
+	/** The estimated size of an RPC's header, which is added to the parameters */
+	static constexpr int32 RpcHeaderSize = 4;
+};
+
+#if WITH_CAMERA_NET_PROFILER
+#define CAMERA_NET_RECORD(Actor, Name, Event, Bytes) FCameraNetProfiler::Record(Actor, Name, Event, Bytes)
+#define CAMERA_NET_RECORD_REPLICATED(Actor, Name, Condition, Bytes) FCameraNetProfiler::RecordReplicated(Actor, Name, Condition, Bytes)
+#else
+#define CAMERA_NET_RECORD(Actor, Name, Event, Bytes)
+#define CAMERA_NET_RECORD_REPLICATED(Actor, Name, Condition, Bytes)
+#endif
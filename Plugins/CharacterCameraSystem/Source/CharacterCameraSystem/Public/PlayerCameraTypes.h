@@ -3,8 +3,12 @@
 
 #include "CoreMinimal.h"
 #include "Engine/DataAsset.h"
+#include "Engine/NetSerialization.h"
+#include "ProfilingDebugging/CsvProfiler.h"
 #include "PlayerCameraTypes.generated.h"
 
+DECLARE_STATS_GROUP(TEXT("Character Camera"), STATGROUP_CharacterCamera, STATCAT_Advanced);
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(CHARACTERCAMERASYSTEM_API, CharacterCamera);
 
 /** The different camera styles */
 #define CameraStyle_None FName("None")
@@ -14,6 +18,8 @@
 #define CameraStyle_ThirdPerson FName("ThirdPerson")
 #define CameraStyle_TargetLocking FName("TargetLocking")
 #define CameraStyle_Aiming FName("Aiming")
+#define CameraStyle_Rail FName("Rail")
+#define CameraStyle_GroupFraming FName("GroupFraming")
 
 
 
@@ -48,6 +54,58 @@ enum class EPreviousTargetLockOrientation : uint8
 };
 
 
+/**
+*	The result of selecting the next target lock character
+*/
+UENUM(BlueprintType, Category = "Camera")
+enum class ETargetSelectionResult : uint8
+{
+	/** There aren't any targets to select from */
+	NoTargets					UMETA(DisplayName = "No Targets"),
+
+	/** The current target shouldn't be changed */
+	Unchanged					UMETA(DisplayName = "Unchanged"),
+
+	/** A new target was selected */
+	Selected					UMETA(DisplayName = "Selected")
+};
+
+
+/**
+*	How the camera manager publishes the final view each frame. The view target's POV (and the camera cache) is always updated,
+*	this only determines whether the camera manager actor follows it, and how expensive that update is
+*/
+UENUM(BlueprintType, Category = "Camera")
+enum class ECameraTransformSync : uint8
+{
+	/** Moves the camera manager with SetActorLocationAndRotation, which is the default engine behavior */
+	SetActorTransform			UMETA(DisplayName = "Set Actor Transform"),
+
+	/** Teleports the camera manager's root component without any overlap or physics updates */
+	Teleport					UMETA(DisplayName = "Teleport"),
+
+	/** Only publishes the view through the view target, the camera manager actor isn't moved */
+	ViewTargetOnly				UMETA(DisplayName = "View Target Only")
+};
+
+
+/**
+*	How a camera style updates the character's rotation
+*/
+UENUM(BlueprintType, Category = "Camera")
+enum class ECameraRotationMode : uint8
+{
+	/** The character's rotation settings aren't changed */
+	Unchanged					UMETA(DisplayName = "Unchanged"),
+
+	/** The character turns towards the direction it's moving. @see ACharacterCameraLogic::SetRotationToMovement */
+	ToMovement					UMETA(DisplayName = "To Movement"),
+
+	/** The character faces the direction of the camera. @see ACharacterCameraLogic::SetRotationToCamera */
+	ToCamera					UMETA(DisplayName = "To Camera")
+};
+
+
 
 
 /**
@@ -92,3 +150,589 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Camera")                     float AngleFromForwardVector;
     
 };
+
+
+
+
+/*
+* The camera state changes of a character within a frame, sent once the character's camera events are flushed
+*/
+USTRUCT(BlueprintType, Category = "Camera")
+struct FCameraStateChange
+{
+	GENERATED_USTRUCT_BODY()
+
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Camera")                     FName OldStyle = CameraStyle_None;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Camera")                     FName NewStyle = CameraStyle_None;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Camera")                     ECameraOrientation OldOrientation = ECameraOrientation::None;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Camera")                     ECameraOrientation NewOrientation = ECameraOrientation::None;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Camera")                     TObjectPtr<AActor> OldTarget = nullptr;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Camera")                     TObjectPtr<AActor> NewTarget = nullptr;
+
+	/** Whether the style, orientation, or target lock were updated this frame, even if the values are the same */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Camera")                     bool bStyleUpdated = false;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Camera")                     bool bOrientationUpdated = false;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Camera")                     bool bTargetUpdated = false;
+
+};
+
+/** The camera events that are waiting to be flushed */
+enum class ECameraEventFlags : uint8
+{
+	None			= 0,
+	Style			= 1 << 0,
+	Orientation		= 1 << 1,
+	Target			= 1 << 2
+};
+ENUM_CLASS_FLAGS(ECameraEventFlags);
+
+
+
+
+/*
+* The camera arm's settings for a camera style and orientation
+*/
+USTRUCT(BlueprintType, Category = "Camera")
+struct FCameraArmConfiguration
+{
+	GENERATED_USTRUCT_BODY()
+
+public:
+	/** The camera's offset. The forward and side offsets are applied to the socket, and the height is applied to the arm's origin */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Camera")                     FVector Offset = FVector::ZeroVector;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Camera")                     float ArmLength = 0.0f;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Camera")                     bool bEnableCameraLag = false;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Camera")                     float LagSpeed = 0.0f;
+
+	/** Blends between two configurations. The lag is enabled while either of them use it */
+	static FCameraArmConfiguration Blend(const FCameraArmConfiguration& A, const FCameraArmConfiguration& B, const float Alpha)
+	{
+		FCameraArmConfiguration Result;
+		Result.Offset = FMath::Lerp(A.Offset, B.Offset, Alpha);
+		Result.ArmLength = FMath::Lerp(A.ArmLength, B.ArmLength, Alpha);
+		Result.bEnableCameraLag = Alpha < 1.0f ? A.bEnableCameraLag || B.bEnableCameraLag : B.bEnableCameraLag;
+		Result.LagSpeed = FMath::Lerp(A.bEnableCameraLag ? A.LagSpeed : B.LagSpeed, B.bEnableCameraLag ? B.LagSpeed : A.LagSpeed, Alpha);
+		return Result;
+	}
+
+};
+
+
+/*
+* The camera arm configurations and rotation of a custom camera style. Orientations without a configuration use the default configuration
+*/
+USTRUCT(BlueprintType, Category = "Camera")
+struct FCameraStyleConfiguration
+{
+	GENERATED_USTRUCT_BODY()
+
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Camera")                     ECameraRotationMode RotationMode = ECameraRotationMode::Unchanged;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Camera")                     FCameraArmConfiguration Default;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Camera")                     TMap<ECameraOrientation, FCameraArmConfiguration> Orientations;
+
+};
+
+
+/*
+* A transition between two camera arm configurations, evaluated once per frame by the character or the camera rig subsystem
+*/
+struct FCameraArmBlend
+{
+	FCameraArmConfiguration Source;
+	FCameraArmConfiguration Target;
+	float Alpha = 1.0f;
+	float Speed = 0.0f;
+
+	bool IsActive() const { return Alpha < 1.0f; }
+
+	/** Moves the blend towards the target configuration */
+	void Advance(const float DeltaTime)
+	{
+		Alpha = FMath::FInterpTo(Alpha, 1.0f, DeltaTime, Speed);
+		if (Alpha >= 1.0f - UE_KINDA_SMALL_NUMBER) Alpha = 1.0f;
+	}
+
+	/** Returns the configuration at the current point of the blend */
+	FCameraArmConfiguration Evaluate() const
+	{
+		return IsActive() ? FCameraArmConfiguration::Blend(Source, Target, Alpha) : Target;
+	}
+};
+
+
+
+
+/*
+* A player's view as it's known on the server, used for camera driven network priority and relevancy
+*/
+struct FCameraNetView
+{
+	FVector Location = FVector::ZeroVector;
+	FVector Direction = FVector::ForwardVector;
+	float CosHalfFOV = 0.0f;
+	bool bValid = false;
+};
+
+
+/*
+* A bounding sphere of a group of moving members that's updated incrementally. A member that moves outside of the sphere grows it in O(1), and members that move within it cost nothing. \n\n
+*
+* Growing alone never shrinks the sphere once the group comes back together, so a second sphere is rebuilt in the background from a few members each frame (Refine),
+* and replaces the current sphere once it's covered every member. Both spheres grow with the members that move, so they always contain the whole group.
+* The spheres are Ritter style bounds, which are within a few percent of the minimal sphere for camera framing purposes
+*/
+struct FCameraGroupBounds
+{
+	TArray<FVector> Members;
+	FVector Center = FVector::ZeroVector;
+	float Radius = -1.0f;
+
+	/** The sphere that's being rebuilt, and the next member it includes */
+	FVector RebuildCenter = FVector::ZeroVector;
+	float RebuildRadius = -1.0f;
+	int32 RebuildCursor = 0;
+
+	void Reset()
+	{
+		Members.Reset();
+		Radius = -1.0f;
+		RebuildRadius = -1.0f;
+		RebuildCursor = 0;
+	}
+
+	bool IsValid() const { return Radius >= 0.0f; }
+
+	/** Adds a member, and grows the sphere to include it */
+	void AddMember(const FVector& Location)
+	{
+		Members.Add(Location);
+		Grow(Center, Radius, Location);
+		Grow(RebuildCenter, RebuildRadius, Location);
+	}
+
+	/** Moves a member. Members that moved less than the tolerance or are still within the spheres don't change them */
+	void UpdateMember(const int32 Index, const FVector& Location, const float Tolerance = 1.0f)
+	{
+		if (FVector::DistSquared(Members[Index], Location) <= FMath::Square(Tolerance)) return;
+		Members[Index] = Location;
+		Grow(Center, Radius, Location);
+		Grow(RebuildCenter, RebuildRadius, Location);
+	}
+
+	/** Includes the next members in the rebuilt sphere, and replaces the current sphere once the rebuild has covered every member */
+	void Refine(const int32 Budget)
+	{
+		for (int32 Step = 0; Step < Budget && !Members.IsEmpty(); ++Step)
+		{
+			if (RebuildCursor >= Members.Num())
+			{
+				Center = RebuildCenter;
+				Radius = RebuildRadius;
+				RebuildRadius = -1.0f;
+				RebuildCursor = 0;
+			}
+
+			Grow(RebuildCenter, RebuildRadius, Members[RebuildCursor++]);
+		}
+	}
+
+	/** Grows a sphere the least amount that includes a point, moving it's center towards the point. A negative radius is an empty sphere */
+	static void Grow(FVector& SphereCenter, float& SphereRadius, const FVector& Point)
+	{
+		if (SphereRadius < 0.0f)
+		{
+			SphereCenter = Point;
+			SphereRadius = 0.0f;
+			return;
+		}
+
+		const FVector Offset = Point - SphereCenter;
+		const float DistanceSquared = Offset.SizeSquared();
+		if (DistanceSquared <= FMath::Square(SphereRadius)) return;
+
+		const float Distance = FMath::Sqrt(DistanceSquared);
+		const float NewRadius = (SphereRadius + Distance) * 0.5f;
+		SphereCenter += Offset * ((NewRadius - SphereRadius) / Distance);
+		SphereRadius = NewRadius;
+	}
+};
+
+
+/*
+* The memory a camera character owns, by category. The inline sizes are part of the objects themselves, and the allocated sizes are their heap allocations
+*/
+struct FCameraMemoryBreakdown
+{
+	enum ECategory : uint8
+	{
+		PostProcess,
+		Components,
+		TargetLocking,
+		ArmTable,
+		Networking,
+		Other,
+		NumCategories
+	};
+
+	SIZE_T Inline[NumCategories] = {};
+	SIZE_T Allocated[NumCategories] = {};
+
+	void Add(const ECategory Category, const SIZE_T InlineSize, const SIZE_T AllocatedSize)
+	{
+		Inline[Category] += InlineSize;
+		Allocated[Category] += AllocatedSize;
+	}
+
+	SIZE_T GetTotal(const ECategory Category) const { return Inline[Category] + Allocated[Category]; }
+
+	SIZE_T GetTotal() const
+	{
+		SIZE_T Total = 0;
+		for (int32 Category = 0; Category < NumCategories; ++Category) Total += GetTotal(static_cast<ECategory>(Category));
+		return Total;
+	}
+
+	FCameraMemoryBreakdown& operator+=(const FCameraMemoryBreakdown& Other)
+	{
+		for (int32 Category = 0; Category < NumCategories; ++Category)
+		{
+			Inline[Category] += Other.Inline[Category];
+			Allocated[Category] += Other.Allocated[Category];
+		}
+		return *this;
+	}
+
+	static const TCHAR* GetCategoryName(const ECategory Category)
+	{
+		static const TCHAR* Names[NumCategories] = { TEXT("PostProcess"), TEXT("Components"), TEXT("TargetLocking"), TEXT("ArmTable"), TEXT("Networking"), TEXT("Other") };
+		return Names[Category];
+	}
+};
+
+
+/*
+* The totals a character's spectator director interest is built from. The damage and target locks are only known on the server, so the server keeps these up to date
+* and replicates them, and each director turns the changes since it last looked into events. @see ACharacterCameraLogic::DirectorState
+*/
+USTRUCT(BlueprintType, Category = "Camera")
+struct FCameraDirectorState
+{
+	GENERATED_USTRUCT_BODY()
+
+public:
+	/** The total damage the character has taken and dealt */
+	UPROPERTY(BlueprintReadOnly, Category="Camera")                                    float DamageTaken = 0.0f;
+	UPROPERTY(BlueprintReadOnly, Category="Camera")                                    float DamageDealt = 0.0f;
+
+	/** The number of times the character has locked on to a new target */
+	UPROPERTY(BlueprintReadOnly, Category="Camera")                                    int32 TargetLocks = 0;
+
+	/** The character's current target lock target */
+	UPROPERTY(BlueprintReadOnly, Category="Camera")                                    TObjectPtr<AActor> Target;
+
+	UPROPERTY(BlueprintReadOnly, Category="Camera")                                    bool bTargetLocking = false;
+
+	/** The estimated size of the state once it's serialized, for the camera net profiler */
+	static constexpr int32 EstimatedNetSize = 17;
+
+	bool operator==(const FCameraDirectorState& Other) const
+	{
+		return DamageTaken == Other.DamageTaken && DamageDealt == Other.DamageDealt && TargetLocks == Other.TargetLocks && Target == Other.Target && bTargetLocking == Other.bTargetLocking;
+	}
+
+	bool operator!=(const FCameraDirectorState& Other) const { return !(*this == Other); }
+
+};
+
+
+/*
+* A player the spectator director is able to view, and how interesting they are. Events add interest that decays over time, which is evaluated lazily from when it was last added,
+* and the state interest (nearby combatants and target locking) is refreshed each time the director visits the candidate
+*/
+struct FCameraDirectorCandidate
+{
+	TWeakObjectPtr<AActor> Actor;
+	FVector Location = FVector::ZeroVector;
+
+	/** The director's grid cell the candidate was in at it's last visit. @see ABasePlayerCameraManager::DirectorCellCounts */
+	FIntPoint Cell = FIntPoint::ZeroValue;
+
+	/** The candidate's replicated director state at it's last visit, the changes since then are the new events */
+	FCameraDirectorState LastState;
+	float EventInterest = 0.0f;
+	double EventTime = 0.0;
+	float StateInterest = 0.0f;
+
+	/** Returns the event interest, decayed to a point in time */
+	float GetEventInterest(const double Time, const float DecayRate) const
+	{
+		return EventInterest * FMath::Exp(-DecayRate * static_cast<float>(Time - EventTime));
+	}
+
+	/** Adds interest from an event */
+	void AddEventInterest(const float Interest, const double Time, const float DecayRate)
+	{
+		EventInterest = GetEventInterest(Time, DecayRate) + Interest;
+		EventTime = Time;
+	}
+
+	float GetScore(const double Time, const float DecayRate) const { return GetEventInterest(Time, DecayRate) + StateInterest; }
+};
+
+
+/*
+* A player's final camera view, quantized for replication to the players spectating them. The location is relative to the player's character so it stays small,
+* the rotation is compressed to shorts and the field of view to a degree. This isn't net serialized as a whole, so replication only sends the members that changed
+*/
+USTRUCT(BlueprintType, Category = "Camera")
+struct FSpectatorViewSample
+{
+	GENERATED_USTRUCT_BODY()
+
+public:
+	/** The camera's location relative to the character, rounded to a centimeter */
+	UPROPERTY()                                                                        FVector_NetQuantize RelativeLocation = FVector::ZeroVector;
+	UPROPERTY()                                                                        uint16 Pitch = 0;
+	UPROPERTY()                                                                        uint16 Yaw = 0;
+	UPROPERTY()                                                                        uint16 Roll = 0;
+	UPROPERTY()                                                                        uint8 FOV = 90;
+
+	/** The estimated size of a sample once it's serialized, for the camera net profiler */
+	static constexpr int32 EstimatedNetSize = 12;
+
+	/** Quantizes a view relative to a character's location */
+	static FSpectatorViewSample Quantize(const FVector& ViewLocation, const FRotator& ViewRotation, const float ViewFOV, const FVector& CharacterLocation)
+	{
+		FSpectatorViewSample Sample;
+		Sample.RelativeLocation = FVector(FMath::RoundToDouble(ViewLocation.X - CharacterLocation.X), FMath::RoundToDouble(ViewLocation.Y - CharacterLocation.Y), FMath::RoundToDouble(ViewLocation.Z - CharacterLocation.Z));
+		Sample.Pitch = FRotator::CompressAxisToShort(ViewRotation.Pitch);
+		Sample.Yaw = FRotator::CompressAxisToShort(ViewRotation.Yaw);
+		Sample.Roll = FRotator::CompressAxisToShort(ViewRotation.Roll);
+		Sample.FOV = static_cast<uint8>(FMath::Clamp(FMath::RoundToInt(ViewFOV), 1, 179));
+		return Sample;
+	}
+
+	FRotator GetRotation() const
+	{
+		return FRotator(FRotator::DecompressAxisFromShort(Pitch), FRotator::DecompressAxisFromShort(Yaw), FRotator::DecompressAxisFromShort(Roll));
+	}
+
+	bool operator==(const FSpectatorViewSample& Other) const
+	{
+		return RelativeLocation == Other.RelativeLocation && Pitch == Other.Pitch && Yaw == Other.Yaw && Roll == Other.Roll && FOV == Other.FOV;
+	}
+
+	bool operator!=(const FSpectatorViewSample& Other) const { return !(*this == Other); }
+
+};
+
+
+/*
+* The spectator view samples a spectating client has received, played back a short delay behind the newest sample so there's always a pair to interpolate between
+*/
+struct FSpectatorViewBuffer
+{
+	struct FEntry
+	{
+		FSpectatorViewSample Sample;
+		double ReceiveTime = 0.0;
+	};
+
+	static constexpr int32 Capacity = 8;
+
+	/** Samples received after a longer gap than this restart the buffer, so playback doesn't blend from a view that's long gone */
+	static constexpr double MaxGap = 1.0;
+
+	FEntry Entries[Capacity];
+	int32 Head = 0;
+	int32 Num = 0;
+
+	void Reset() { Head = 0; Num = 0; }
+
+	/** Adds a sample, replacing the oldest one once the buffer is full */
+	void Add(const FSpectatorViewSample& Sample, const double ReceiveTime)
+	{
+		if (Num > 0 && ReceiveTime - GetNewestTime() > MaxGap) Reset();
+		Entries[(Head + Num) % Capacity] = { Sample, ReceiveTime };
+		if (Num < Capacity) ++Num;
+		else Head = (Head + 1) % Capacity;
+	}
+
+	/** Returns the time the newest sample was received, or zero if there aren't any */
+	double GetNewestTime() const { return Num > 0 ? Entries[(Head + Num - 1) % Capacity].ReceiveTime : 0.0; }
+
+	/**
+	 * Interpolates the samples at a point in time, relative to the character's location. Times outside of the buffer hold the oldest or newest sample
+	 * @returns false if there aren't any samples
+	 */
+	bool Evaluate(const double Time, const FVector& CharacterLocation, FVector& OutLocation, FRotator& OutRotation, float& OutFOV) const
+	{
+		if (Num == 0) return false;
+
+		const FEntry* From = &Entries[Head];
+		const FEntry* To = From;
+		for (int32 Index = 1; Index < Num; ++Index)
+		{
+			const FEntry& Entry = Entries[(Head + Index) % Capacity];
+			To = &Entry;
+			if (Entry.ReceiveTime >= Time) break;
+			From = &Entry;
+		}
+
+		const double Duration = To->ReceiveTime - From->ReceiveTime;
+		const float Alpha = Duration > UE_SMALL_NUMBER ? FMath::Clamp(static_cast<float>((Time - From->ReceiveTime) / Duration), 0.0f, 1.0f) : 1.0f;
+		OutLocation = CharacterLocation + FMath::Lerp(FVector(From->Sample.RelativeLocation), FVector(To->Sample.RelativeLocation), Alpha);
+		OutRotation = FQuat::Slerp(From->Sample.GetRotation().Quaternion(), To->Sample.GetRotation().Quaternion(), Alpha).Rotator();
+		OutFOV = FMath::Lerp(static_cast<float>(From->Sample.FOV), static_cast<float>(To->Sample.FOV), Alpha);
+		return true;
+	}
+};
+
+
+
+/*
+* A camera view the owning client reports to the server for it's view history, stamped with the client's estimate of the server's time
+*/
+USTRUCT()
+struct FCameraViewReport
+{
+	GENERATED_USTRUCT_BODY()
+
+public:
+	/** The client's estimate of the server's world time when the view was rendered. @see AGameStateBase::GetServerWorldTimeSeconds */
+	UPROPERTY()                                                                        double ServerTime = 0.0;
+	UPROPERTY()                                                                        FVector_NetQuantize Location = FVector::ZeroVector;
+	UPROPERTY()                                                                        uint16 Pitch = 0;
+	UPROPERTY()                                                                        uint16 Yaw = 0;
+
+	/** The estimated size of a report once it's serialized, for the camera net profiler */
+	static constexpr int32 EstimatedNetSize = 20;
+
+	static FCameraViewReport Quantize(const double ServerTime, const FVector& ViewLocation, const FRotator& ViewRotation)
+	{
+		FCameraViewReport Report;
+		Report.ServerTime = ServerTime;
+		Report.Location = ViewLocation;
+		Report.Pitch = FRotator::CompressAxisToShort(ViewRotation.Pitch);
+		Report.Yaw = FRotator::CompressAxisToShort(ViewRotation.Yaw);
+		return Report;
+	}
+
+};
+
+
+/*
+* The camera views a client has reported to the server, for looking up where the player was aiming at the time of a shot. \n\n
+*
+* The history is a fixed size ring of timestamped views with the location rounded to a centimeter and the rotation compressed to shorts, so each player's history is
+* the same small size no matter how long they play. The entries are in time order, so a lookup is a binary search and an interpolation between the pair around the time
+*/
+struct FCameraViewHistory
+{
+	struct FEntry
+	{
+		double Time = 0.0;
+		FIntVector Location = FIntVector::ZeroValue;
+		uint16 Pitch = 0;
+		uint16 Yaw = 0;
+	};
+
+	/** The number of views that are kept. At the default rate of 20 views a second, this covers a little over three seconds */
+	static constexpr int32 Capacity = 64;
+
+	FEntry Entries[Capacity];
+	int32 Head = 0;
+	int32 Num = 0;
+
+	void Reset() { Head = 0; Num = 0; }
+
+	/**
+	 * Adds a view, replacing the oldest one once the history is full
+	 * @returns false if the view is older than the newest one, which happens when unreliable reports arrive out of order
+	 */
+	bool Add(const FCameraViewReport& Report)
+	{
+		if (Num > 0 && Report.ServerTime <= GetNewestTime()) return false;
+
+		FEntry& Entry = Entries[(Head + Num) % Capacity];
+		Entry.Time = Report.ServerTime;
+		Entry.Location = FIntVector(FMath::RoundToInt(Report.Location.X), FMath::RoundToInt(Report.Location.Y), FMath::RoundToInt(Report.Location.Z));
+		Entry.Pitch = Report.Pitch;
+		Entry.Yaw = Report.Yaw;
+
+		if (Num < Capacity) ++Num;
+		else Head = (Head + 1) % Capacity;
+		return true;
+	}
+
+	/** Returns the entry at an index from the oldest entry */
+	const FEntry& Get(const int32 Index) const { return Entries[(Head + Index) % Capacity]; }
+
+	/** Returns the time of the oldest and newest views, or zero if there aren't any */
+	double GetOldestTime() const { return Num > 0 ? Get(0).Time : 0.0; }
+	double GetNewestTime() const { return Num > 0 ? Get(Num - 1).Time : 0.0; }
+
+	/**
+	 * Interpolates the views at a point in time. Times outside of the history hold the oldest or newest view
+	 * @returns false if there aren't any views
+	 */
+	bool Evaluate(const double Time, FVector& OutLocation, FRotator& OutRotation) const
+	{
+		if (Num == 0) return false;
+
+		// The first view at or after the time
+		int32 Low = 0;
+		int32 High = Num;
+		while (Low < High)
+		{
+			const int32 Middle = (Low + High) / 2;
+			if (Get(Middle).Time < Time) Low = Middle + 1;
+			else High = Middle;
+		}
+
+		const FEntry& To = Get(FMath::Min(Low, Num - 1));
+		const FEntry& From = Get(FMath::Max(Low - 1, 0));
+		const double Duration = To.Time - From.Time;
+		const float Alpha = Duration > UE_SMALL_NUMBER ? FMath::Clamp(static_cast<float>((Time - From.Time) / Duration), 0.0f, 1.0f) : 1.0f;
+
+		const FQuat FromRotation = FRotator(FRotator::DecompressAxisFromShort(From.Pitch), FRotator::DecompressAxisFromShort(From.Yaw), 0.0).Quaternion();
+		const FQuat ToRotation = FRotator(FRotator::DecompressAxisFromShort(To.Pitch), FRotator::DecompressAxisFromShort(To.Yaw), 0.0).Quaternion();
+		OutLocation = FMath::Lerp(FVector(From.Location), FVector(To.Location), Alpha);
+		OutRotation = FQuat::Slerp(FromRotation, ToRotation, Alpha).Rotator();
+		return true;
+	}
+};
+
+
+
+/*
+* The dynamic state of a character's camera rig, for carrying the camera over to a new pawn after a respawn or travel instead of starting it from scratch. \n\n
+*
+* The lag is stored relative to the arm's location and desired rotation, so restoring it onto a pawn somewhere else puts the camera in the same place behind the new pawn.
+* @see ACharacterCameraLogic::CaptureCameraRigSnapshot, UCameraRigSnapshotSubsystem
+*/
+USTRUCT(BlueprintType)
+struct FCameraRigSnapshot
+{
+	GENERATED_USTRUCT_BODY()
+
+public:
+	/** The lagged camera location and arm origin, relative to the arm's location in the frame of it's desired rotation */
+	UPROPERTY(BlueprintReadOnly, Category="Camera")                                    FVector RelativeDesiredLoc = FVector::ZeroVector;
+	UPROPERTY(BlueprintReadOnly, Category="Camera")                                    FVector RelativeArmOrigin = FVector::ZeroVector;
+
+	/** The lagged rotation, relative to the arm's desired rotation */
+	UPROPERTY(BlueprintReadOnly, Category="Camera")                                    FQuat RotationLag = FQuat::Identity;
+
+	/** The arm's settings, which are mid transition if the style or orientation was changing */
+	UPROPERTY(BlueprintReadOnly, Category="Camera")                                    FCameraArmConfiguration ArmConfiguration;
+
+	UPROPERTY(BlueprintReadOnly, Category="Camera")                                    FName CameraStyle;
+	UPROPERTY(BlueprintReadOnly, Category="Camera")                                    ECameraOrientation CameraOrientation = ECameraOrientation::Center;
+
+	/** False until the snapshot's been captured */
+	UPROPERTY(BlueprintReadOnly, Category="Camera")                                    bool bValid = false;
+
+};
@@ -0,0 +1,48 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CameraLoadTestSubsystem.generated.h"
+
+class ACharacterCameraLogic;
+
+
+/**
+ * Sets up a camera load test from the command line, for the multi process runs in Scripts/CameraLoadTest.py. This is only created in non shipping game worlds that are launched with one of these:
+ *  - -CameraBotTargets=N: the server spawns N target characters in a ring around the world origin, for the bots to lock on to
+ *  - -CameraBots: the client adds a @ref UCameraBotComponent to each local player's character, which drives the camera like a player would
+ *
+ * The camera networking counters are logged when the world is torn down, so the server's log has the per connection traffic of the run
+ */
+UCLASS()
+class CHARACTERCAMERASYSTEM_API UCameraLoadTestSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+	/** The spawned target characters */
+	UPROPERTY(Transient) TArray<TObjectPtr<ACharacterCameraLogic>> Targets;
+
+	/** Adds the bots once the local players have possessed their characters */
+	FTimerHandle BotTimer;
+
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Spawns the target characters */
+	virtual void SpawnTargets(int32 NumTargets);
+
+	/** Adds a camera bot to each local player's character that doesn't have one */
+	virtual void AddBots();
+
+
+};
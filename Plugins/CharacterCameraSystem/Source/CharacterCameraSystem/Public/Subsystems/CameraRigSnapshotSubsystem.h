@@ -0,0 +1,39 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PlayerCameraTypes.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "CameraRigSnapshotSubsystem.generated.h"
+
+
+/**
+ * Keeps each local player's last camera rig snapshot across level travel, since the camera manager and the pawn are both destroyed with the level.
+ * The camera manager stores the snapshot when it loses the player's pawn, and restores it onto the player's next pawn. @see ABasePlayerCameraManager::bWarmStartCameraRig
+ */
+UCLASS()
+class CHARACTERCAMERASYSTEM_API UCameraRigSnapshotSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+	/** The snapshot of each local player, keyed by the local player's controller id */
+	TMap<int32, FCameraRigSnapshot> Snapshots;
+
+
+public:
+	/** Stores a local player's snapshot, replacing the previous one */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Snapshot") virtual void StoreSnapshot(int32 ControllerId, const FCameraRigSnapshot& Snapshot);
+
+	/**
+	 * Finds a local player's snapshot
+	 * @returns false if the player doesn't have a snapshot
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Snapshot") virtual bool FindSnapshot(int32 ControllerId, FCameraRigSnapshot& OutSnapshot) const;
+
+	/** Removes a local player's snapshot, so their next pawn starts with a fresh camera */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Snapshot") virtual void ClearSnapshot(int32 ControllerId);
+
+
+};
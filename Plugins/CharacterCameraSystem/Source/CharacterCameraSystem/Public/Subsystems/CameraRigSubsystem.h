@@ -0,0 +1,79 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CameraComponents/TargetLockSpringArm.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CameraRigSubsystem.generated.h"
+
+class UCameraClearanceField;
+class ULevel;
+
+
+/**
+ * Updates every batched camera rig (@ref UTargetLockSpringArm with bUseBatchedRigUpdate) in a single pass instead of through individual component ticks. \n\n
+ *
+ * The update is split into three phases:
+ *  - Gather: the settings, inputs and lag state of each rig are copied into contiguous arrays on the game thread
+ *  - Solve: the socket transitions and the lag/target lock math run in a ParallelFor, without touching any objects
+ *  - Commit: collision sweeps and the transform updates are applied serially on the game thread
+ *
+ * @remarks This ticks after the post physics tick group and before the camera managers update, which is the same window the spring arm's tick uses
+ */
+UCLASS()
+class CHARACTERCAMERASYSTEM_API UCameraRigSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+	/** The batched rigs */
+	UPROPERTY(Transient) TArray<TObjectPtr<UTargetLockSpringArm>> Rigs;
+
+	/** The baked camera clearance field of each level, which every camera rig in the world uses for static collision. These are removed along with their level */
+	UPROPERTY(Transient) TMap<TObjectPtr<ULevel>, TObjectPtr<UCameraClearanceField>> ClearanceFields;
+
+	FDelegateHandle LevelRemovedHandle;
+
+	/** Rig data for the current update. These are kept between frames to avoid reallocating them */
+	TArray<UTargetLockSpringArm*> ActiveRigs;
+	TArray<FCameraRigSettings> RigSettings;
+	TArray<FCameraRigInput> RigInputs;
+	TArray<FCameraRigState> RigStates;
+	TArray<FCameraRigOutput> RigOutputs;
+	TArray<FCameraRigSocketBlend> SocketBlends;
+
+
+public:
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/** Adds a rig to the batched update */
+	virtual void RegisterRig(UTargetLockSpringArm* Rig);
+
+	/** Removes a rig from the batched update */
+	virtual void UnregisterRig(UTargetLockSpringArm* Rig);
+
+	/** Returns the number of batched rigs */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Rig") int32 GetNumRigs() const;
+
+	/**
+	 * Sets the camera clearance field of a level, or the persistent level if there isn't one. Call this once the level is loaded, the field is cleared when the level is removed from the world.
+	 * A null field clears the level's field
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Rig") virtual void SetClearanceField(UCameraClearanceField* Field, ULevel* Level = nullptr);
+
+	/** Returns the baked camera clearance field that covers a location, if any of the loaded levels have one */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Rig") UCameraClearanceField* GetClearanceField(const FVector& Location) const;
+
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Removes the clearance field of a level that's been unloaded */
+	virtual void OnLevelRemovedFromWorld(ULevel* Level, UWorld* World);
+
+
+};
@@ -0,0 +1,145 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CameraSignificanceSubsystem.generated.h"
+
+class USignificanceManager;
+class USkeletalMeshComponent;
+
+
+/*
+* A significance bucket and how often the actors within it are updated
+*/
+USTRUCT(BlueprintType, Category = "Camera")
+struct FCameraSignificanceBucket
+{
+	GENERATED_USTRUCT_BODY()
+		FCameraSignificanceBucket(
+			const float MinSignificance = 0.0,
+			const float TickInterval = 0.0
+		) :
+
+		MinSignificance(MinSignificance),
+		TickInterval(TickInterval)
+	{}
+
+public:
+	/** The lowest significance that's within this bucket */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Camera")                     float MinSignificance;
+
+	/** The tick interval of the actor and it's skeletal meshes while they're within this bucket. Zero ticks every frame */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Camera")                     float TickInterval;
+
+};
+
+
+/** A local player's view, captured from it's camera manager before the significance is updated */
+struct FCameraSignificanceView
+{
+	FVector Location = FVector::ZeroVector;
+	FVector Direction = FVector::ForwardVector;
+	float HalfFOV = 0.0f;
+};
+
+
+/** The tick intervals a registered actor and it's skeletal meshes had before the significance buckets changed them */
+struct FCameraSignificanceTickIntervals
+{
+	float ActorTickInterval = 0.0f;
+	TArray<TPair<TWeakObjectPtr<USkeletalMeshComponent>, float>, TInlineAllocator<2>> MeshTickIntervals;
+};
+
+
+/**
+ * Drives the USignificanceManager from the camera managers of every local player, so actors are updated based on what the cameras actually show. \n\n
+ *
+ * An actor's significance is based on it's distance from the camera, whether it's bounds are within the camera's view, and whether it was recently rendered as an occlusion hint.
+ * Each registered actor is placed in a significance bucket which adjusts the tick interval of the actor and it's skeletal meshes, and the current target of each local player is always in the highest bucket. \n\n
+ *
+ * @remarks The views are from the camera cache, which is one frame behind since the cameras update after the tickable objects. Dedicated servers don't have any views and are never updated
+ */
+UCLASS(Config = Game)
+class CHARACTERCAMERASYSTEM_API UCameraSignificanceSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** The significance tag of the actors registered with this subsystem */
+	static const FName SignificanceTag;
+
+	/** The distance where an actor's significance reaches zero */
+	UPROPERTY(Config, EditAnywhere, BlueprintReadWrite, Category = "Camera|Significance") float MaxSignificanceDistance;
+
+	/** Scales the significance of actors outside of the camera's view */
+	UPROPERTY(Config, EditAnywhere, BlueprintReadWrite, Category = "Camera|Significance") float OffScreenSignificanceScale;
+
+	/** Scales the significance of actors within the camera's view that haven't been rendered recently, which is usually because they're occluded */
+	UPROPERTY(Config, EditAnywhere, BlueprintReadWrite, Category = "Camera|Significance") float OccludedSignificanceScale;
+
+	/** How long an actor can go without being rendered before it's considered occluded */
+	UPROPERTY(Config, EditAnywhere, BlueprintReadWrite, Category = "Camera|Significance") float OcclusionGracePeriod;
+
+	/** The significance buckets, from the highest to the lowest significance */
+	UPROPERTY(Config, EditAnywhere, BlueprintReadWrite, Category = "Camera|Significance") TArray<FCameraSignificanceBucket> Buckets;
+
+
+protected:
+	/** The views of the local players for the current update */
+	TArray<FCameraSignificanceView> Views;
+
+	/** The current targets of the local players, these always have the highest significance */
+	TArray<const AActor*, TInlineAllocator<4>> PinnedActors;
+
+	/** The view transforms passed to the significance manager */
+	TArray<FTransform, TInlineAllocator<4>> ViewTransforms;
+
+	/** The original tick intervals of the registered actors, which are restored when they're unregistered */
+	TMap<TObjectKey<AActor>, FCameraSignificanceTickIntervals> OriginalTickIntervals;
+
+
+public:
+	UCameraSignificanceSubsystem();
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/** Registers an actor with the significance manager. The actor is unregistered when it ends play */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Significance") virtual void RegisterActor(AActor* Actor);
+
+	/** Unregisters an actor from the significance manager and restores the tick intervals it had when it was registered */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Significance") virtual void UnregisterActor(AActor* Actor);
+
+	/** Returns the significance bucket of a registered actor, where zero is the highest significance */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Significance") int32 GetActorSignificanceBucket(const AActor* Actor) const;
+
+	/** Returns the bucket of a significance value */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Significance") int32 GetSignificanceBucket(float Significance) const;
+
+
+protected:
+	/** Captures the views and current targets of the local players */
+	virtual void GatherViews();
+
+	/** Calculates an actor's significance for one of the views. This is called from the significance manager's worker threads, and shouldn't modify anything */
+	virtual float CalculateSignificance(const AActor* Actor, const FTransform& ViewTransform) const;
+
+	/** Applies a significance bucket's tick interval to an actor and it's skeletal meshes */
+	virtual void ApplySignificanceBucket(AActor* Actor, int32 Bucket) const;
+
+	/** Restores the tick intervals an actor and it's skeletal meshes had when it was registered */
+	virtual void RestoreTickIntervals(AActor* Actor);
+
+	/** Unregisters actors once they've ended play */
+	UFUNCTION() virtual void OnRegisteredActorEndPlay(AActor* Actor, EEndPlayReason::Type EndPlayReason);
+
+	/** Returns the significance manager of this world, if there is one */
+	USignificanceManager* GetSignificanceManager() const;
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+
+};
@@ -0,0 +1,119 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PlayerCameraTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CameraTargetingSubsystem.generated.h"
+
+class ACharacterCameraLogic;
+
+
+/*
+* A request for selecting the next target of a character, used for batched target selection
+*/
+USTRUCT(BlueprintType, Category = "Camera")
+struct FCameraTargetRequest
+{
+	GENERATED_USTRUCT_BODY()
+		FCameraTargetRequest(
+			ACharacterCameraLogic* Character = nullptr,
+			const EPreviousTargetLockOrientation NextTargetDirection = EPreviousTargetLockOrientation::Right
+		) :
+
+		Character(Character),
+		NextTargetDirection(NextTargetDirection)
+	{}
+
+public:
+	/** The character selecting a target */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Camera")                     TObjectPtr<ACharacterCameraLogic> Character;
+
+	/**
+	 * The targets to select from. If this is empty the character's current target lock characters are used. \n
+	 * Otherwise the character's target lock characters are replaced with these (not merged), so they're also what the character re-evaluates and navigates between afterwards
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Camera")                     TArray<AActor*> Candidates;
+
+	/** Which direction to navigate from the current target */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Camera")                     EPreviousTargetLockOrientation NextTargetDirection;
+
+};
+
+
+/** The cached target scores of a character that's being re-evaluated */
+struct FTargetReevaluationState
+{
+	TWeakObjectPtr<ACharacterCameraLogic> Character;
+
+	/** The targets and their scores from the most recent pass over the character's target lock characters */
+	TArray<TPair<TWeakObjectPtr<AActor>, float>> CachedScores;
+
+	/** The next target lock character to score */
+	int32 NextCandidate = 0;
+};
+
+
+/**
+ * Target selection for many characters at once. This is intended for servers with a lot of ai characters, where calling AdjustCurrentTarget on each character is too expensive. \n\n
+ *
+ * The requests are gathered on the game thread, scored on worker threads with the same logic as ACharacterCameraLogic::SelectNextTarget, and the selected targets are written back on the game thread.
+ * The results are identical to AdjustCurrentTarget's default logic, without the debug logging and the target lock data that's saved on each character \n\n
+ *
+ * This also handles the background target re-evaluation for characters with bReevaluateTargets. Each frame it scores a few target lock characters within a time budget,
+ * going round robin over every character that's target locking, and once a character's targets have all been scored it switches or breaks the target lock based on the cached scores.
+ * A target that's no longer valid is handled as soon as it's character is visited, so no frame has to rescan every target.
+ */
+UCLASS()
+class CHARACTERCAMERASYSTEM_API UCameraTargetingSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+	/** The characters that are target locking with target re-evaluation enabled */
+	TArray<FTargetReevaluationState> ReevaluationStates;
+
+	/** The next character to re-evaluate */
+	int32 NextReevaluation = 0;
+
+	/** Batched target selection data. These are kept between batches to avoid reallocating them */
+	TArray<ACharacterCameraLogic*> BatchCharacters;
+	TArray<int32> BatchCandidateStart;
+	TArray<int32> BatchCandidateNum;
+	TArray<FVector> BatchPlayerLocations;
+	TArray<FRotator> BatchAimRotations;
+	TArray<AActor*> BatchPreviousTargets;
+	TArray<AActor*> BatchCandidates;
+	TArray<FVector> BatchCandidateLocations;
+	TArray<ETargetSelectionResult> BatchResults;
+	TArray<AActor*> BatchSelectedTargets;
+
+
+public:
+	/**
+	 * Selects the next target for each of the requests, and applies it to the requesting character. Requests with candidates replace the character's target lock characters with them
+	 * @returns the number of characters that selected a new target
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Camera|Target Locking") virtual int32 BatchAdjustCurrentTargets(const TArray<FCameraTargetRequest>& Requests);
+
+	/** Adds a character to the background target re-evaluation */
+	virtual void RegisterTargetReevaluation(ACharacterCameraLogic* Character);
+
+	/** Removes a character from the background target re-evaluation. The character's state is cleared right away and removed on the next tick, since this can be called while resolving */
+	virtual void UnregisterTargetReevaluation(ACharacterCameraLogic* Character);
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual void Deinitialize() override;
+
+
+protected:
+	/** Scores the next target of a character. Returns true once every target has been scored and the character was resolved */
+	virtual bool ReevaluateNextCandidate(FTargetReevaluationState& State);
+
+	/** Switches or breaks the character's target lock based on the cached scores */
+	virtual void ResolveTargetReevaluation(FTargetReevaluationState& State);
+
+
+};